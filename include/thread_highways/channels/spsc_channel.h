@@ -0,0 +1,170 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_CHANNELS_SPSC_CHANNEL_H
+#define THREADS_HIGHWAYS_CHANNELS_SPSC_CHANNEL_H
+
+#include <thread_highways/channels/i_subscription.h>
+#include <thread_highways/highways/highway.h>
+#include <thread_highways/highways/i_highway_input.h>
+#include <thread_highways/tools/spsc_queue.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace hi
+{
+
+/**
+ * @brief SpscChannel
+ * Channel from one producer thread (another highway for example) to one consumer highway:
+ *  the publications go through SpscQueue (no CAS, no holders) and are read by the consumer highway in batches.
+ * The object itself is the producer end, the callback is executed on the consumer highway.
+ * Waking up the consumer costs a fence and a load (no read-modify-write while the consumer is awake).
+ * @note publish() and try_publish() must be called from one thread at a time
+ * @note the channel is closed by the destructor: the consumer executes what is left and forgets the channel
+ */
+template <typename Publication, typename HighWayType = HighWay>
+class SpscChannel
+{
+public:
+	/**
+	 * @brief SpscChannel
+	 * @param callback - executed on the consumer highway: (Publication publication[, const std::atomic<bool> &
+	 * keep_execution])
+	 * @param highway - consumer highway
+	 * @param filename - file where the code is located
+	 * @param line - line in the file that contains the code
+	 * @param capacity - how many publications can wait in the queue
+	 * @param max_batch - how many publications the consumer executes in a row before returning to its mailbox
+	 */
+	template <typename R>
+	SpscChannel(
+		R && callback,
+		std::shared_ptr<HighWayType> highway,
+		const char * filename,
+		const unsigned int line,
+		const std::uint32_t capacity = 1024u,
+		const std::uint32_t max_batch = 64u)
+		: highway_{std::move(highway)}
+		, input_{std::make_shared<Input<R>>(std::move(callback), filename, line, capacity, max_batch)}
+	{
+		highway_->add_input(input_);
+	}
+
+	SpscChannel(const SpscChannel &) = delete;
+	SpscChannel & operator=(const SpscChannel &) = delete;
+
+	~SpscChannel()
+	{
+		input_->closed_.store(true, std::memory_order_release);
+		highway_->wake();
+	}
+
+	/**
+	 * @brief publish
+	 * Will yield while the queue is full
+	 * @param publication - dropped if the consumer highway is destroyed
+	 */
+	void publish(Publication publication)
+	{
+		while (!input_->queue_.try_push(std::move(publication)))
+		{
+			if (!highway_->is_running())
+				return;
+			std::this_thread::yield();
+		}
+		highway_->wake();
+	}
+
+	/**
+	 * @brief try_publish
+	 * @param publication
+	 * @return false if the queue is full
+	 */
+	bool try_publish(Publication publication)
+	{
+		if (!input_->queue_.try_push(std::move(publication)))
+			return false;
+		highway_->wake();
+		return true;
+	}
+
+private:
+	struct InputBase : public IHighWayInput
+	{
+		InputBase(const char * filename, const unsigned int line, const std::uint32_t capacity)
+			: queue_{capacity}
+			, filename_{filename}
+			, line_{line}
+		{
+		}
+
+		bool has_work() const noexcept final
+		{
+			return !queue_.empty() || closed_.load(std::memory_order_relaxed);
+		}
+
+		const char * get_code_filename() const noexcept final
+		{
+			return filename_;
+		}
+
+		unsigned int get_code_line() const noexcept final
+		{
+			return line_;
+		}
+
+		SpscQueue<Publication> queue_;
+		std::atomic<bool> closed_{false};
+		const char * const filename_;
+		const unsigned int line_;
+	};
+
+	template <typename R>
+	struct Input : public InputBase
+	{
+		Input(R && callback, const char * filename, const unsigned int line, const std::uint32_t capacity, const std::uint32_t max_batch)
+			: InputBase{filename, line, capacity}
+			, callback_{std::move(callback)}
+			, max_batch_{max_batch ? max_batch : 1u}
+		{
+		}
+
+		bool execute(const std::atomic<bool> & keep_execution) final
+		{
+			// everything published before closing is executed
+			const bool closed = this->closed_.load(std::memory_order_acquire);
+			this->queue_.pop_batch(
+				[&](Publication && publication)
+				{
+					if (!send_with_params<R, Publication>(callback_, std::move(publication), keep_execution))
+					{
+						throw Exception(
+							"Error: subscription callback must take parameters: Publication publication, "
+							"[[maybe_unused]] const std::atomic<bool>& keep_execution",
+							this->filename_,
+							this->line_);
+					}
+				},
+				max_batch_);
+			return !closed || !this->queue_.empty();
+		}
+
+		R callback_;
+		const std::uint32_t max_batch_;
+	};
+
+private:
+	const std::shared_ptr<HighWayType> highway_;
+	const std::shared_ptr<InputBase> input_;
+}; // SpscChannel
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_CHANNELS_SPSC_CHANNEL_H
@@ -8,10 +8,15 @@
 #ifndef THREADS_HIGHWAYS_EXECUTION_TREE_RESCHEDULABLERUNNABLE_H
 #define THREADS_HIGHWAYS_EXECUTION_TREE_RESCHEDULABLERUNNABLE_H
 
+#include <thread_highways/execution_tree/runnable.h>
 #include <thread_highways/execution_tree/schedule.h>
 #include <thread_highways/tools/safe_invoke.h>
 
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
 
 namespace hi
 {
@@ -21,8 +26,11 @@ namespace hi
  * This task can reschedule itself.
  * Может использоваться для высокоприоритетных задач:
  * проверка необходимости запуска происходит на каждом такте хайвея
+ * The code to execute is placed inside the task if it fits into InlineSize bytes
+ * (and is nothrow move constructible), otherwise it is allocated on the heap.
  */
-class ReschedulableRunnable
+template <std::size_t InlineSize>
+class BasicReschedulableRunnable
 {
 public:
 	/**
@@ -34,7 +42,7 @@ public:
 	 * @note filename and line will used for error and freeze logging
 	 */
 	template <typename R>
-	static ReschedulableRunnable create(
+	static BasicReschedulableRunnable create(
 		R && r,
 		std::chrono::steady_clock::time_point next_execution_time,
 		const char * filename,
@@ -84,9 +92,17 @@ public:
 					assert(false);
 				}
 			}
+
+			RunnableHolder * move_to(void * buffer) noexcept override
+			{
+				return new (buffer) RunnableHolderImpl{std::move(r_)};
+			}
+
 			R r_;
 		};
-		return ReschedulableRunnable{new RunnableHolderImpl{std::move(r)}, next_execution_time, filename, line};
+		BasicReschedulableRunnable re{next_execution_time, filename, line};
+		re.template emplace<RunnableHolderImpl, R>(std::move(r));
+		return re;
 	}
 
 	/**
@@ -100,7 +116,7 @@ public:
 	 * @note filename and line will used for error and freeze logging
 	 */
 	template <typename R, typename P>
-	static ReschedulableRunnable create(
+	static BasicReschedulableRunnable create(
 		R && runnable,
 		P protector,
 		std::chrono::steady_clock::time_point next_execution_time,
@@ -152,38 +168,42 @@ public:
 					assert(false);
 				}
 			}
+
+			RunnableHolder * move_to(void * buffer) noexcept override
+			{
+				return new (buffer) RunnableProtectedHolderImpl{std::move(runnable_), std::move(protector_)};
+			}
+
 			R runnable_;
 			P protector_;
 		};
-		return ReschedulableRunnable{
-			new RunnableProtectedHolderImpl{std::move(runnable), std::move(protector)},
-			next_execution_time,
-			filename,
-			line};
+		BasicReschedulableRunnable re{next_execution_time, filename, line};
+		re.template emplace<RunnableProtectedHolderImpl, R, P>(std::move(runnable), std::move(protector));
+		return re;
 	}
 
-	~ReschedulableRunnable()
+	~BasicReschedulableRunnable()
 	{
-		delete runnable_;
+		release();
 	}
-	ReschedulableRunnable(const ReschedulableRunnable & rhs) = delete;
-	ReschedulableRunnable & operator=(const ReschedulableRunnable & rhs) = delete;
-	ReschedulableRunnable(ReschedulableRunnable && rhs)
+	BasicReschedulableRunnable(const BasicReschedulableRunnable & rhs) = delete;
+	BasicReschedulableRunnable & operator=(const BasicReschedulableRunnable & rhs) = delete;
+	BasicReschedulableRunnable(BasicReschedulableRunnable && rhs) noexcept
 		: filename_{std::move(rhs.filename_)}
 		, line_{rhs.line_}
-		, runnable_{rhs.runnable_}
+		, schedule_{rhs.schedule_}
 	{
-		rhs.runnable_ = nullptr;
+		take(rhs);
 	}
-	ReschedulableRunnable & operator=(ReschedulableRunnable && rhs)
+	BasicReschedulableRunnable & operator=(BasicReschedulableRunnable && rhs) noexcept
 	{
 		if (this == &rhs)
 			return *this;
+		release();
 		filename_ = std::move(rhs.filename_);
 		line_ = rhs.line_;
-		delete runnable_;
-		runnable_ = rhs.runnable_;
-		rhs.runnable_ = nullptr;
+		take(rhs);
+		schedule_ = rhs.schedule_;
 		return *this;
 	}
 
@@ -207,31 +227,87 @@ public:
 		return schedule_;
 	}
 
+	// true if the code to execute is placed inside the task (no heap allocation)
+	bool is_inline() const noexcept
+	{
+		const std::less<const void *> less;
+		const void * ptr = runnable_;
+		return runnable_ && !less(ptr, buffer_) && less(ptr, buffer_ + sizeof(buffer_));
+	}
+
 private:
 	struct RunnableHolder
 	{
 		virtual ~RunnableHolder() = default;
 		virtual void operator()(Schedule & schedule, const std::atomic<bool> & keep_execution) = 0;
+		// Moves the implementation into the buffer of another task
+		virtual RunnableHolder * move_to(void * buffer) noexcept = 0;
 	};
 
-	ReschedulableRunnable(
-		RunnableHolder * runnable,
+	BasicReschedulableRunnable(
 		std::chrono::steady_clock::time_point next_execution_time,
 		const char * filename,
 		unsigned int line)
-		: filename_{std::move(filename)}
+		: filename_{filename}
 		, line_{line}
-		, runnable_{runnable}
 	{
 		schedule_.next_execution_time_ = next_execution_time;
 	}
 
+	template <typename Impl, typename... Args>
+	void emplace(Args &&... args)
+	{
+		if constexpr (
+			sizeof(Impl) <= InlineSize && alignof(Impl) <= alignof(std::max_align_t)
+			&& std::conjunction_v<std::is_nothrow_move_constructible<Args>...>)
+		{
+			runnable_ = new (buffer_) Impl{std::forward<Args>(args)...};
+		}
+		else
+		{
+			runnable_ = new Impl{std::forward<Args>(args)...};
+		}
+	}
+
+	void release() noexcept
+	{
+		if (runnable_)
+		{
+			if (is_inline())
+			{
+				runnable_->~RunnableHolder();
+			}
+			else
+			{
+				delete runnable_;
+			}
+			runnable_ = nullptr;
+		}
+	}
+
+	void take(BasicReschedulableRunnable & rhs) noexcept
+	{
+		if (rhs.is_inline())
+		{
+			runnable_ = rhs.runnable_->move_to(buffer_);
+			rhs.release();
+		}
+		else
+		{
+			runnable_ = rhs.runnable_;
+			rhs.runnable_ = nullptr;
+		}
+	}
+
 	const char * filename_;
 	unsigned int line_;
 	RunnableHolder * runnable_{nullptr};
 	Schedule schedule_;
+	alignas(std::max_align_t) unsigned char buffer_[InlineSize ? InlineSize : 1u];
 };
 
+using ReschedulableRunnable = BasicReschedulableRunnable<runnable_inline_size>;
+
 } // namespace hi
 
 #endif // THREADS_HIGHWAYS_EXECUTION_TREE_RESCHEDULABLERUNNABLE_H
@@ -12,14 +12,29 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
 
 namespace hi
 {
 
-// A task for execution on highway.
-class Runnable
+// Size of the buffer inside the task for placing the code to execute without heap allocation
+inline constexpr std::size_t runnable_inline_size{48u};
+
+/*
+ * A task for execution on highway.
+ * The code to execute is placed inside the task if it fits into InlineSize bytes
+ * (and is nothrow move constructible), otherwise it is allocated on the heap.
+ */
+template <std::size_t InlineSize>
+class BasicRunnable
 {
 public:
+	// The mailboxes of the highways can allocate the holders of the tasks in slabs (see SlabHolders)
+	static constexpr bool slab_holders_{true};
+
 	/**
 	 * Creating a template task without a protector
 	 *
@@ -29,7 +44,7 @@ public:
 	 * @note filename and line will used for error and freeze logging
 	 */
 	template <typename R>
-	static Runnable create(R && r, const char * filename, unsigned int line)
+	static BasicRunnable create(R && r, const char * filename, unsigned int line)
 	{
 		struct RunnableHolderImpl : public RunnableHolder
 		{
@@ -76,9 +91,16 @@ public:
 				}
 			}
 
+			RunnableHolder * move_to(void * buffer) noexcept override
+			{
+				return new (buffer) RunnableHolderImpl{std::move(r_)};
+			}
+
 			R r_;
 		};
-		return Runnable{new RunnableHolderImpl{std::move(r)}, std::move(filename), line};
+		BasicRunnable re{filename, line};
+		re.template emplace<RunnableHolderImpl, R>(std::move(r));
+		return re;
 	}
 
 	/**
@@ -92,7 +114,7 @@ public:
 	 * @note filename and line will used for error and freeze logging
 	 */
 	template <typename R, typename P>
-	static Runnable create(R && runnable, P protector, const char * filename, unsigned int line)
+	static BasicRunnable create(R && runnable, P protector, const char * filename, unsigned int line)
 	{
 		struct RunnableProtectedHolderImpl : public RunnableHolder
 		{
@@ -139,10 +161,17 @@ public:
 				}
 			}
 
+			RunnableHolder * move_to(void * buffer) noexcept override
+			{
+				return new (buffer) RunnableProtectedHolderImpl{std::move(runnable_), std::move(protector_)};
+			}
+
 			R runnable_;
 			P protector_;
 		};
-		return Runnable{new RunnableProtectedHolderImpl{std::move(runnable), std::move(protector)}, filename, line};
+		BasicRunnable re{filename, line};
+		re.template emplace<RunnableProtectedHolderImpl, R, P>(std::move(runnable), std::move(protector));
+		return re;
 	}
 
 	void clear()
@@ -150,38 +179,32 @@ public:
 		static const char * null_object_filename{"null object"};
 		filename_ = null_object_filename;
 		line_ = 0u;
-		if (runnable_)
-		{
-			delete runnable_;
-			runnable_ = nullptr;
-		}
+		release();
 	}
-	~Runnable()
+	~BasicRunnable()
 	{
 		clear();
 	}
-	Runnable()
+	BasicRunnable()
 	{
 		clear();
 	}
-	Runnable(const Runnable & rhs) = delete;
-	Runnable & operator=(const Runnable & rhs) = delete;
-	Runnable(Runnable && rhs)
+	BasicRunnable(const BasicRunnable & rhs) = delete;
+	BasicRunnable & operator=(const BasicRunnable & rhs) = delete;
+	BasicRunnable(BasicRunnable && rhs) noexcept
 		: filename_{std::move(rhs.filename_)}
 		, line_{rhs.line_}
-		, runnable_{rhs.runnable_}
 	{
-		rhs.runnable_ = nullptr;
+		take(rhs);
 	}
-	Runnable & operator=(Runnable && rhs)
+	BasicRunnable & operator=(BasicRunnable && rhs) noexcept
 	{
 		if (this == &rhs)
 			return *this;
+		release();
 		filename_ = std::move(rhs.filename_);
 		line_ = rhs.line_;
-		delete runnable_;
-		runnable_ = rhs.runnable_;
-		rhs.runnable_ = nullptr;
+		take(rhs);
 		return *this;
 	}
 
@@ -200,25 +223,82 @@ public:
 		return line_;
 	}
 
+	// true if the code to execute is placed inside the task (no heap allocation)
+	bool is_inline() const noexcept
+	{
+		const std::less<const void *> less;
+		const void * ptr = runnable_;
+		return runnable_ && !less(ptr, buffer_) && less(ptr, buffer_ + sizeof(buffer_));
+	}
+
 private:
 	struct RunnableHolder
 	{
 		virtual ~RunnableHolder() = default;
 		virtual void operator()(const std::atomic<bool> & keep_execution) = 0;
+		// Moves the implementation into the buffer of another task
+		virtual RunnableHolder * move_to(void * buffer) noexcept = 0;
 	};
 
-	Runnable(RunnableHolder * runnable, const char * filename, unsigned int line)
-		: filename_{std::move(filename)}
+	BasicRunnable(const char * filename, unsigned int line)
+		: filename_{filename}
 		, line_{line}
-		, runnable_{runnable}
 	{
 	}
 
+	template <typename Impl, typename... Args>
+	void emplace(Args &&... args)
+	{
+		if constexpr (
+			sizeof(Impl) <= InlineSize && alignof(Impl) <= alignof(std::max_align_t)
+			&& std::conjunction_v<std::is_nothrow_move_constructible<Args>...>)
+		{
+			runnable_ = new (buffer_) Impl{std::forward<Args>(args)...};
+		}
+		else
+		{
+			runnable_ = new Impl{std::forward<Args>(args)...};
+		}
+	}
+
+	void release() noexcept
+	{
+		if (runnable_)
+		{
+			if (is_inline())
+			{
+				runnable_->~RunnableHolder();
+			}
+			else
+			{
+				delete runnable_;
+			}
+			runnable_ = nullptr;
+		}
+	}
+
+	void take(BasicRunnable & rhs) noexcept
+	{
+		if (rhs.is_inline())
+		{
+			runnable_ = rhs.runnable_->move_to(buffer_);
+			rhs.release();
+		}
+		else
+		{
+			runnable_ = rhs.runnable_;
+			rhs.runnable_ = nullptr;
+		}
+	}
+
 	const char * filename_;
 	unsigned int line_;
 	RunnableHolder * runnable_{nullptr};
+	alignas(std::max_align_t) unsigned char buffer_[InlineSize ? InlineSize : 1u];
 };
 
+using Runnable = BasicRunnable<runnable_inline_size>;
+
 } // namespace hi
 
 #endif // THREADS_HIGHWAYS_EXECUTION_TREE_RUNNABLE_H
@@ -10,22 +10,45 @@
 
 #include <thread_highways/execution_tree/runnable.h>
 #include <thread_highways/execution_tree/reschedulable_runnable.h>
+#include <thread_highways/highways/i_highway_input.h>
+#include <thread_highways/highways/priority_lanes.h>
+#include <thread_highways/highways/work_stealing_pool.h>
 #include <thread_highways/mailboxes/mail_box.h>
+#include <thread_highways/mailboxes/ring_mail_box.h>
 #include <thread_highways/tools/exception.h>
+#include <thread_highways/tools/metrics.h>
 #include <thread_highways/tools/raii_thread.h>
+#include <thread_highways/tools/schedule_heap.h>
+#include <thread_highways/tools/thread_placement.h>
+#include <thread_highways/tools/wait_strategy.h>
+#include <thread_highways/tools/watchdog.h>
 
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <future>
+#include <optional>
+#include <vector>
 
 namespace hi
 {
 
-class HighWay
+/**
+ * @brief BasicHighWay
+ * Single-threaded executor of the tasks: the main mailbox, priority lanes and the schedule.
+ * MainMailBox - the backend of the main mailbox:
+ *  MailBox<Runnable> (holders in the lock-free stacks, the capacity can be changed on the fly) or
+ *  RingMailBox<Runnable> (the tasks are executed in place in a fixed contiguous ring).
+ */
+template <typename MainMailBox>
+class BasicHighWay
 {
+	// The holders of the main mailbox are allocated on demand up to the capacity (the ring is fixed)
+	static constexpr bool resizable_ = std::is_same_v<MainMailBox, MailBox<Runnable>>;
+
 public:
-	HighWay(
-		std::weak_ptr<HighWay> self_weak,
+	BasicHighWay(
+		std::weak_ptr<BasicHighWay> self_weak,
 		ExceptionHandler exception_handler =
 			[](const hi::Exception & ex)
 		{
@@ -34,54 +57,80 @@ public:
 		std::string highway_name = "HighWay",
 		std::chrono::milliseconds max_task_execution_time = {},
 		std::uint32_t mail_box_capacity = 65000u,
-		std::shared_ptr<MailBox<Runnable>> multi_thread_mail_box = nullptr)
+		std::shared_ptr<MailBox<Runnable>> multi_thread_mail_box = nullptr,
+		PriorityLanes priority_lanes = {},
+		ThreadPlacement thread_placement = {},
+		std::shared_ptr<WorkStealingPool> work_stealing_pool = nullptr,
+		HoldersAllocation holders_allocation = {})
 		: self_weak_{std::move(self_weak)}
 		, exception_handler_{std::move(exception_handler)}
 		, highway_name_{std::move(highway_name)}
 		, max_task_execution_time_{max_task_execution_time}
+		, watched_{watch_this_thread()}
 		, multi_thread_mail_box_{std::move(multi_thread_mail_box)}
+		, work_stealing_pool_{std::move(work_stealing_pool)}
+		, priority_lanes_order_{priority_lanes.order_}
+		, default_lane_weight_{priority_lanes.default_lane_weight_ ? priority_lanes.default_lane_weight_ : 1u}
+		, mail_box_{
+			  mail_box_capacity ? mail_box_capacity : MainMailBox::default_capacity_,
+			  main_mail_box_allocation(holders_allocation, thread_placement)}
 	{
-		set_capacity(mail_box_capacity);
+		for (const auto & lane : priority_lanes.lanes_)
+		{
+			priority_lanes_.emplace_back(PriorityLane{std::make_unique<MailBox<Runnable>>(), lane.weight_ ? lane.weight_ : 1u});
+			if (lane.capacity_)
+			{
+				priority_lanes_.back().mail_box_->set_capacity(lane.capacity_);
+			}
+			priority_lanes_.back().mail_box_->set_holders_allocation(holders_allocation);
+		}
+#if THREAD_HIGHWAYS_METRICS
+		mail_box_.set_metrics(metrics_);
+		for (auto & lane : priority_lanes_)
+		{
+			lane.mail_box_->set_metrics(metrics_);
+		}
+#endif
 
 		next_schedule_time_ = std::chrono::steady_clock::now() + std::chrono::hours{24};
-		if (multi_thread_mail_box_)
-		{
-			if (max_task_execution_time_ == std::chrono::milliseconds{})
+		main_thread_ = start_thread(
+			thread_placement,
+			[this, self_protector = self_weak_.lock(), numa_local_holders = thread_placement.numa_local_holders_]
 			{
-				main_thread_ = RAIIthread(std::thread(
-					[this, self_protector = self_weak_.lock()]
+				if (numa_local_holders)
+				{
+					mail_box_.reserve_holders();
+				}
+				// the multi-threaded work is taken from the own deque, the shared mailbox or stolen
+				std::optional<WorkStealingPool::Worker> work_stealing_worker;
+				if (work_stealing_pool_)
+				{
+					work_stealing_worker.emplace(*work_stealing_pool_);
+					work_stealing_worker_ = &*work_stealing_worker;
+				}
+				if (multi_thread_mail_box_)
+				{
+					if (max_task_execution_time_ == std::chrono::milliseconds{})
 					{
 						main_loop_without_time_control_multi(self_protector);
-					}));
-			}
-			else
-			{
-				main_thread_ = RAIIthread(std::thread(
-					[this, self_protector = self_weak_.lock()]
+					}
+					else
 					{
 						main_loop_with_time_control_multi(self_protector);
-					}));
-			}
-		}
-		else
-		{
-			if (max_task_execution_time_ == std::chrono::milliseconds{})
-			{
-				main_thread_ = RAIIthread(std::thread(
-					[this, self_protector = self_weak_.lock()]
+					}
+				}
+				else
+				{
+					if (max_task_execution_time_ == std::chrono::milliseconds{})
 					{
 						main_loop_without_time_control(self_protector);
-					}));
-			}
-			else
-			{
-				main_thread_ = RAIIthread(std::thread(
-					[this, self_protector = self_weak_.lock()]
+					}
+					else
 					{
 						main_loop_with_time_control(self_protector);
-					}));
-			}
-		}
+					}
+				}
+			});
 	}
 
 	/*
@@ -94,12 +143,65 @@ public:
 	*/
 	void set_capacity(const std::uint32_t capacity)
 	{
+		static_assert(resizable_, "the capacity of the ring is set by the constructor of RingHighWay");
 		if (capacity)
 		{
 			mail_box_.set_capacity(capacity);
 		}
 	}
 
+	/**
+	 * @brief set_holders_reclamation
+	 * Returning the holders left after a burst to the heap (main mailbox and priority lanes)
+	 * @param reclamation - low watermark and cool down
+	 * @note must be called right after the creation of the highway (before the tasks are sent), zero cool_down_ turns it off at any time
+	 */
+	void set_holders_reclamation(const HoldersReclamation & reclamation)
+	{
+		static_assert(resizable_, "the ring of RingHighWay has a fixed size, there are no holders to reclaim");
+		mail_box_.set_holders_reclamation(reclamation);
+		for (auto & lane : priority_lanes_)
+		{
+			lane.mail_box_->set_holders_reclamation(reclamation);
+		}
+	}
+
+	/**
+	 * @brief set_wait_strategy
+	 * What the highway thread does when there are no tasks
+	 * @param wait_strategy - block immediately, spin then park, or busy-poll (for the dedicated cores)
+	 * @note can be changed on the fly
+	 */
+	void set_wait_strategy(const WaitStrategy wait_strategy)
+	{
+		wait_strategy_.store(wait_strategy, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief metrics
+	 * Counters of the tasks sent to this highway (main mailbox and priority lanes).
+	 * Lock-free, can be read from any thread.
+	 * @return only holders_* are filled if THREAD_HIGHWAYS_METRICS is disabled
+	 * @note tasks of the manager's multi-thread mailbox are counted by the manager
+	 */
+	MetricsSnapshot metrics() const
+	{
+		MetricsSnapshot re;
+#if THREAD_HIGHWAYS_METRICS
+		re = metrics_->snapshot();
+#endif
+		re.holders_allocated_ = mail_box_.allocated_holders();
+		re.holders_capacity_ = mail_box_.capacity();
+		re.heap_usage_ = mail_box_.heap_usage();
+		for (const auto & lane : priority_lanes_)
+		{
+			re.holders_allocated_ += lane.mail_box_->allocated_holders();
+			re.holders_capacity_ += lane.mail_box_->capacity();
+			re.heap_usage_ += lane.mail_box_->heap_usage();
+		}
+		return re;
+	}
+
 	// Будет пытаться добавить задачу, если ресурсов не осталось то заблокируется в ожидании
 	void execute(Runnable && runnable)
 	{
@@ -174,6 +276,68 @@ public:
 		return try_execute_impl(Runnable::create<R>(std::move(r), std::move(protector), filename, line));
 	}
 
+	/**
+	 * Setting a task for execution in the priority lane
+	 * Будет пытаться добавить задачу, если ресурсов не осталось то заблокируется в ожидании
+	 *
+	 * @param priority - Priority::Default or the priority lane (greater than the number of lanes means the most urgent lane)
+	 * @param runnable - task for execution
+	 */
+	void execute(const Priority priority, Runnable && runnable)
+	{
+		execute_impl(priority, std::move(runnable));
+	}
+
+	template <typename R>
+	void execute(const Priority priority, R && r, const char * filename = __FILE__, const unsigned int line = __LINE__)
+	{
+		execute_impl(priority, Runnable::create<R>(std::move(r), filename, line));
+	}
+
+	template <typename R, typename P>
+	void execute(const Priority priority, R && r, P protector, const char * filename, const unsigned int line)
+	{
+		execute_impl(priority, Runnable::create<R>(std::move(r), std::move(protector), filename, line));
+	}
+
+	// Попытается добавить задачу в приоритетную полосу, если ресурсов не осталось, то вернёт false
+	bool try_execute(const Priority priority, Runnable && runnable)
+	{
+		return try_execute_impl(priority, std::move(runnable));
+	}
+
+	template <typename R>
+	bool try_execute(const Priority priority, R && r, const char * filename = __FILE__, const unsigned int line = __LINE__)
+	{
+		return try_execute_impl(priority, Runnable::create<R>(std::move(r), filename, line));
+	}
+
+	template <typename R, typename P>
+	bool try_execute(const Priority priority, R && r, P protector, const char * filename, const unsigned int line)
+	{
+		return try_execute_impl(priority, Runnable::create<R>(std::move(r), std::move(protector), filename, line));
+	}
+
+	/**
+	 * Setting a batch of tasks for execution with a single publication in the mailbox
+	 *  (one CAS and one wake-up instead of one per task)
+	 * If the holders are over, then the prepared part of the batch is published
+	 *  and it will block in waiting for the holders
+	 *
+	 * @param batch - tasks for execution (will be executed in the order of the vector)
+	 */
+	void execute_batch(std::vector<Runnable> && batch)
+	{
+		mail_box_.send_batch_may_blocked(std::move(batch));
+	}
+
+	// Попытается добавить все задачи разом, если холдеров на весь batch не хватает, то вернёт false
+	// (batch при этом не изменится)
+	bool try_execute_batch(std::vector<Runnable> && batch)
+	{
+		return mail_box_.send_batch_may_fail(std::move(batch));
+	}
+
 	void schedule(ReschedulableRunnable && runnable)
 	{
 		schedule_impl(std::move(runnable));
@@ -204,6 +368,10 @@ public:
 	{
 		keep_execution_.store(false, std::memory_order_release);
 		mail_box_.destroy();
+		for (auto & lane : priority_lanes_)
+		{
+			lane.mail_box_->destroy();
+		}
 		main_thread_.join();
 	}
 
@@ -228,17 +396,246 @@ public:
 		}
 	} // flush_tasks
 
+	/**
+	 * @brief add_input
+	 * Connecting an extra source of work (SpscChannel for example):
+	 *  the highway thread polls it between the tasks until it is closed and drained
+	 * @param input - kept by the highway
+	 */
+	void add_input(IHighWayInputPtr input)
+	{
+		execute(
+			[this, input = std::move(input)]() mutable
+			{
+				inputs_.emplace_back(std::move(input));
+			},
+			__FILE__,
+			__LINE__);
+	}
+
+	// Wakes up the highway thread waiting for the tasks (new work in the inputs)
+	void wake()
+	{
+		mail_box_.wake();
+	}
+
+	// false after destroy() (the highway thread is stopping)
+	[[nodiscard]] bool is_running() const noexcept
+	{
+		return keep_execution_.load(std::memory_order_relaxed);
+	}
+
 private:
+	std::shared_ptr<WatchedThread> watch_this_thread()
+	{
+		if (max_task_execution_time_ == std::chrono::milliseconds{})
+			return nullptr;
+		return Watchdog::instance().watch(highway_name_, max_task_execution_time_, exception_handler_);
+	}
+
+	// With numa_local_holders_ the holders are reserved by the highway thread itself, not by the constructor
+	static HoldersAllocation main_mail_box_allocation(HoldersAllocation holders_allocation, const ThreadPlacement & thread_placement)
+	{
+		if (thread_placement.numa_local_holders_)
+		{
+			holders_allocation.prefault_ = false;
+		}
+		return holders_allocation;
+	}
+
 	void execute_impl(Runnable && runnable)
 	{
 		mail_box_.send_may_blocked(std::move(runnable));
 	}
 
+	void wait_for_tasks(
+		IdleWaiter & idle_waiter,
+		typename MainMailBox::WorkQueue & work_queue,
+		const std::chrono::nanoseconds max_wait)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + max_wait;
+		const bool has_work = idle_waiter.spin(
+			[this]
+			{
+				return mail_box_.has_messages() || (multi_thread_mail_box_ && multi_thread_mail_box_->has_messages())
+					|| has_priority_messages() || has_input_work() || !keep_execution_.load(std::memory_order_relaxed);
+			},
+			deadline);
+		if (has_work)
+		{
+			mail_box_.move_to_no_wait(work_queue);
+		}
+		else if (priority_lanes_.empty() && inputs_.empty())
+		{
+			mail_box_.move_to(work_queue, deadline - std::chrono::steady_clock::now());
+		}
+		else
+		{
+			mail_box_.move_to(
+				work_queue,
+				deadline - std::chrono::steady_clock::now(),
+				[this]
+				{
+					return has_priority_messages() || has_input_work();
+				});
+		}
+	}
+
 	bool try_execute_impl(Runnable && runnable)
 	{
 		return mail_box_.send_may_fail(std::move(runnable));
 	}
 
+	MailBox<Runnable> * priority_lane(const Priority priority)
+	{
+		const auto lane_id = static_cast<std::uint32_t>(priority);
+		if (lane_id == 0u || priority_lanes_.empty())
+			return nullptr;
+		if (lane_id > priority_lanes_.size())
+			return priority_lanes_.back().mail_box_.get();
+		return priority_lanes_[lane_id - 1u].mail_box_.get();
+	}
+
+	void execute_impl(const Priority priority, Runnable && runnable)
+	{
+		auto lane = priority_lane(priority);
+		if (!lane)
+		{
+			execute_impl(std::move(runnable));
+			return;
+		}
+		lane->send_may_blocked(std::move(runnable));
+		// the highway thread waits on the main mailbox
+		mail_box_.wake();
+	}
+
+	bool try_execute_impl(const Priority priority, Runnable && runnable)
+	{
+		auto lane = priority_lane(priority);
+		if (!lane)
+		{
+			return try_execute_impl(std::move(runnable));
+		}
+		if (!lane->send_may_fail(std::move(runnable)))
+			return false;
+		mail_box_.wake();
+		return true;
+	}
+
+	bool has_priority_messages() const noexcept
+	{
+		for (const auto & lane : priority_lanes_)
+		{
+			if (lane.mail_box_->has_messages())
+				return true;
+		}
+		return false;
+	}
+
+	bool has_input_work() const noexcept
+	{
+		for (const auto & input : inputs_)
+		{
+			if (input->has_work())
+				return true;
+		}
+		return false;
+	}
+
+	// Executing a batch from each input (the closed and drained inputs are forgotten)
+	void execute_inputs()
+	{
+		for (auto it = inputs_.begin(); it != inputs_.end() && keep_execution_.load(std::memory_order_relaxed);)
+		{
+			auto & input = **it;
+			if (!input.has_work())
+			{
+				++it;
+				continue;
+			}
+			bool keep_input{true};
+			if (watched_)
+			{
+				watched_->task_started(input.get_code_filename(), input.get_code_line());
+			}
+			try
+			{
+				keep_input = input.execute(keep_execution_);
+			}
+			catch (const hi::Exception & e)
+			{
+				exception_handler_(e);
+			}
+			catch (...)
+			{
+				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
+			}
+			if (watched_)
+			{
+				watched_->task_finished();
+			}
+			it = keep_input ? it + 1 : inputs_.erase(it);
+		}
+	}
+
+	/**
+	 * Executing the tasks from the priority lanes (the most urgent lane first)
+	 * @param execute_runnable - how to execute the holder and return it to the mailbox
+	 * @param default_lane_empty - there are no tasks from the main mailbox waiting for execution
+	 */
+	template <typename ExecuteRunnable>
+	void execute_priority_lanes(ExecuteRunnable & execute_runnable, const bool default_lane_empty)
+	{
+		if (priority_lanes_.empty())
+			return;
+
+		if (priority_lanes_order_ == PriorityLanes::Order::Strict)
+		{
+			// after each task starting again from the most urgent lane
+			for (auto it = priority_lanes_.rbegin();
+				 it != priority_lanes_.rend() && keep_execution_.load(std::memory_order_relaxed);)
+			{
+				auto & mail_box = *it->mail_box_;
+				if (auto holder = mail_box.has_messages() ? mail_box.pop_message_no_wait() : nullptr)
+				{
+					execute_runnable(holder, mail_box);
+					it = priority_lanes_.rbegin();
+				}
+				else
+				{
+					++it;
+				}
+			}
+			return;
+		}
+
+		// WeightedRoundRobin: the main mailbox spends its weight between the rounds
+		if (!default_lane_empty && default_lane_budget_ > 0u)
+		{
+			--default_lane_budget_;
+			return;
+		}
+		default_lane_budget_ = default_lane_weight_ - 1u;
+		bool executed{false};
+		do
+		{
+			executed = false;
+			for (auto it = priority_lanes_.rbegin(); it != priority_lanes_.rend(); ++it)
+			{
+				auto & mail_box = *it->mail_box_;
+				for (std::uint32_t i = 0; i < it->weight_ && mail_box.has_messages(); ++i)
+				{
+					auto holder = mail_box.pop_message_no_wait();
+					if (!holder || !keep_execution_.load(std::memory_order_relaxed))
+						break;
+					execute_runnable(holder, mail_box);
+					executed = true;
+				}
+			}
+		}
+		while (executed && default_lane_empty && keep_execution_.load(std::memory_order_relaxed));
+	}
+
 	void schedule_impl(ReschedulableRunnable && runnable)
 	{
 		execute(
@@ -248,14 +645,15 @@ private:
 				{
 					next_schedule_time_ = runnable.schedule().next_execution_time_;
 				}
-				schedule_stack_.push(new hi::Holder<ReschedulableRunnable>(std::move(runnable)));
+				schedule_heap_.push(new hi::Holder<ReschedulableRunnable>(std::move(runnable)));
 			});
 	}
 
-	void main_loop_without_time_control(const std::shared_ptr<HighWay> self_protector)
+	void main_loop_without_time_control(const std::shared_ptr<BasicHighWay> self_protector)
 	{
 		SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack;
-		SingleThreadStack<Holder<Runnable>> work_queue;
+		typename MainMailBox::WorkQueue work_queue;
+		IdleWaiter idle_waiter{wait_strategy_};
 		auto time = std::chrono::steady_clock::now();
 		const auto execute_reschedulable_runnable = [&](Holder<ReschedulableRunnable> * holder)
 		{
@@ -275,10 +673,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -292,32 +686,27 @@ private:
 			time = std::chrono::steady_clock::now();
 			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
-		const auto execute_runnable = [&](Holder<Runnable> * holder)
+		const auto execute_runnable = [&](auto * holder, auto & mail_box)
 		{
+			const MetricsScope metrics_scope{mail_box.metrics(), *holder};
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -330,20 +719,25 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			mail_box_.free_holder(holder);
+			mail_box.free_holder(holder);
 		};
 
 		// main loop
 		while (keep_execution_.load(std::memory_order_acquire))
 		{
 			time = std::chrono::steady_clock::now();
-			mail_box_.move_to(
+			wait_for_tasks(
+				idle_waiter,
 				work_queue,
 				std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - time));
 			check_schedules();
+			execute_priority_lanes(execute_runnable, work_queue.empty());
+			execute_inputs();
 			while (auto holder = work_queue.pop())
 			{
-				execute_runnable(holder);
+				execute_priority_lanes(execute_runnable, false);
+				execute_inputs();
+				execute_runnable(holder, mail_box_);
 				if (!keep_execution_.load(std::memory_order_relaxed))
 				{
 					return;
@@ -355,13 +749,15 @@ private:
 		self_protector->keep_execution_ = false;
 	} // main_loop_without_time_control
 
-	void main_loop_with_time_control(const std::shared_ptr<HighWay> self_protector)
+	void main_loop_with_time_control(const std::shared_ptr<BasicHighWay> self_protector)
 	{
-		auto before_time = std::chrono::steady_clock::now();
+		auto time = std::chrono::steady_clock::now();
 		SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack;
-		SingleThreadStack<Holder<Runnable>> work_queue;
+		typename MainMailBox::WorkQueue work_queue;
+		IdleWaiter idle_waiter{wait_strategy_};
 		const auto execute_reschedulable_runnable = [&](Holder<ReschedulableRunnable> * holder)
 		{
+			watched_->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.schedule().rechedule_ = false;
@@ -375,23 +771,10 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					highway_name_ + ":ReschedulableRunnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched_->task_finished();
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -402,35 +785,31 @@ private:
 
 		const auto check_schedules = [&]
 		{
-			if (before_time >= next_schedule_time_)
+			time = std::chrono::steady_clock::now();
+			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = before_time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (before_time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
-		const auto execute_runnable = [&](Holder<Runnable> * holder)
+		const auto execute_runnable = [&](auto * holder, auto & mail_box)
 		{
-			before_time = std::chrono::steady_clock::now();
+			const MetricsScope metrics_scope{mail_box.metrics(), *holder};
+			watched_->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -443,30 +822,26 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					highway_name_ + ":Runnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched_->task_finished();
 
-			mail_box_.free_holder(holder);
+			mail_box.free_holder(holder);
 		};
 
 		// main loop
 		while (keep_execution_.load(std::memory_order_acquire))
 		{
-			mail_box_.move_to(
+			wait_for_tasks(
+				idle_waiter,
 				work_queue,
-				std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - before_time));
+				std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - time));
 			check_schedules();
+			execute_priority_lanes(execute_runnable, work_queue.empty());
+			execute_inputs();
 			while (auto holder = work_queue.pop())
 			{
-				execute_runnable(holder);
+				execute_priority_lanes(execute_runnable, false);
+				execute_inputs();
+				execute_runnable(holder, mail_box_);
 				if (!keep_execution_.load(std::memory_order_relaxed))
 				{
 					return;
@@ -478,10 +853,11 @@ private:
 		self_protector->keep_execution_ = false;
 	} // main_loop_with_time_control
 
-	void main_loop_without_time_control_multi(const std::shared_ptr<HighWay> self_protector)
+	void main_loop_without_time_control_multi(const std::shared_ptr<BasicHighWay> self_protector)
 	{
 		SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack;
-		SingleThreadStack<Holder<Runnable>> work_queue;
+		typename MainMailBox::WorkQueue work_queue;
+		IdleWaiter idle_waiter{wait_strategy_};
 		auto time = std::chrono::steady_clock::now();
 		const auto execute_reschedulable_runnable = [&](Holder<ReschedulableRunnable> * holder)
 		{
@@ -501,10 +877,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -518,32 +890,27 @@ private:
 			time = std::chrono::steady_clock::now();
 			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
-		const auto execute_runnable = [&](Holder<Runnable> * holder)
+		const auto execute_runnable = [&](auto * holder, auto & mail_box)
 		{
+			const MetricsScope metrics_scope{mail_box.metrics(), *holder};
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -556,7 +923,7 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			mail_box_.free_holder(holder);
+			mail_box.free_holder(holder);
 		};
 
 		// main loop
@@ -564,6 +931,8 @@ private:
 		{
 			mail_box_.move_to_no_wait(work_queue);
 			check_schedules();
+			execute_priority_lanes(execute_runnable, work_queue.empty());
+			execute_inputs();
 
 			if (work_queue.empty())
 			{
@@ -577,13 +946,15 @@ private:
 					auto wait_time = std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - time);
 					if (wait_time > permissible_delay_time_)
 						wait_time = permissible_delay_time_;
-					mail_box_.move_to(work_queue, wait_time);
+					wait_for_tasks(idle_waiter, work_queue, wait_time);
 				}
 			}
 
 			while (auto holder = work_queue.pop())
 			{
-				execute_runnable(holder);
+				execute_priority_lanes(execute_runnable, false);
+				execute_inputs();
+				execute_runnable(holder, mail_box_);
 				if (!keep_execution_.load(std::memory_order_relaxed))
 				{
 					return;
@@ -595,13 +966,15 @@ private:
 		self_protector->keep_execution_ = false;
 	} // main_loop_without_time_control_multi
 
-	void main_loop_with_time_control_multi(const std::shared_ptr<HighWay> self_protector)
+	void main_loop_with_time_control_multi(const std::shared_ptr<BasicHighWay> self_protector)
 	{
-		auto before_time = std::chrono::steady_clock::now();
+		auto time = std::chrono::steady_clock::now();
 		SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack;
-		SingleThreadStack<Holder<Runnable>> work_queue;
+		typename MainMailBox::WorkQueue work_queue;
+		IdleWaiter idle_waiter{wait_strategy_};
 		const auto execute_reschedulable_runnable = [&](Holder<ReschedulableRunnable> * holder)
 		{
+			watched_->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.schedule().rechedule_ = false;
@@ -615,23 +988,10 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					highway_name_ + ":ReschedulableRunnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched_->task_finished();
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -642,35 +1002,31 @@ private:
 
 		const auto check_schedules = [&]
 		{
-			if (before_time >= next_schedule_time_)
+			time = std::chrono::steady_clock::now();
+			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = before_time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (before_time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
-		const auto execute_runnable = [&](Holder<Runnable> * holder)
+		const auto execute_runnable = [&](auto * holder, auto & mail_box)
 		{
-			before_time = std::chrono::steady_clock::now();
+			const MetricsScope metrics_scope{mail_box.metrics(), *holder};
+			watched_->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -683,18 +1039,9 @@ private:
 			{
 				exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					highway_name_ + ":Runnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched_->task_finished();
 
-			mail_box_.free_holder(holder);
+			mail_box.free_holder(holder);
 		};
 
 		// main loop
@@ -702,6 +1049,8 @@ private:
 		{
 			mail_box_.move_to_no_wait(work_queue);
 			check_schedules();
+			execute_priority_lanes(execute_runnable, work_queue.empty());
+			execute_inputs();
 
 			if (work_queue.empty())
 			{
@@ -712,16 +1061,18 @@ private:
 				else
 				{
 					auto wait_time =
-						std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - before_time);
+						std::chrono::duration_cast<std::chrono::nanoseconds>(next_schedule_time_ - time);
 					if (wait_time > permissible_delay_time_)
 						wait_time = permissible_delay_time_;
-					mail_box_.move_to(work_queue, wait_time);
+					wait_for_tasks(idle_waiter, work_queue, wait_time);
 				}
 			}
 
 			while (auto holder = work_queue.pop())
 			{
-				execute_runnable(holder);
+				execute_priority_lanes(execute_runnable, false);
+				execute_inputs();
+				execute_runnable(holder, mail_box_);
 				if (!keep_execution_.load(std::memory_order_relaxed))
 				{
 					return;
@@ -735,9 +1086,11 @@ private:
 
 	bool exec_one_from_multi_thread_mail_box()
 	{
-		auto holder = multi_thread_mail_box_->pop_message_no_wait();
+		auto holder = work_stealing_worker_ ? work_stealing_worker_->pop_no_wait()
+											: multi_thread_mail_box_->pop_message_no_wait();
 		if (!holder)
 			return false;
+		const MetricsScope metrics_scope{multi_thread_mail_box_->metrics(), *holder};
 
 		try
 		{
@@ -758,10 +1111,12 @@ private:
 
 	bool exec_one_from_multi_thread_mail_box_with_time_control()
 	{
-		auto holder = multi_thread_mail_box_->pop_message_no_wait();
+		auto holder = work_stealing_worker_ ? work_stealing_worker_->pop_no_wait()
+											: multi_thread_mail_box_->pop_message_no_wait();
 		if (!holder)
 			return false;
-		const auto before_time = std::chrono::steady_clock::now();
+		const MetricsScope metrics_scope{multi_thread_mail_box_->metrics(), *holder};
+		watched_->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 		try
 		{
 			holder->t_.run(keep_execution_);
@@ -774,23 +1129,14 @@ private:
 		{
 			exception_handler_(hi::Exception{highway_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 		}
-		const auto after_time = std::chrono::steady_clock::now();
-		const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-
-		if (time_diff > max_task_execution_time_)
-		{
-			exception_handler_(hi::Exception{
-				highway_name_ + ":Runnable:stuck for ms = " + std::to_string(time_diff.count()),
-				holder->t_.get_code_filename(),
-				holder->t_.get_code_line()});
-		}
+		watched_->task_finished();
 
 		multi_thread_mail_box_->free_holder(holder);
 		return true;
 	}
 
 private:
-	const std::weak_ptr<HighWay> self_weak_;
+	const std::weak_ptr<BasicHighWay> self_weak_;
 	const ExceptionHandler exception_handler_;
 	const std::string highway_name_;
 
@@ -799,22 +1145,51 @@ private:
 
 	// если задан, то будет контроль времени исполнения - всё что дольше попадёт в exception_handler_
 	const std::chrono::milliseconds max_task_execution_time_;
+	// the stuck tasks are reported by the watchdog while they are still running
+	const std::shared_ptr<WatchedThread> watched_;
 	const std::shared_ptr<MailBox<Runnable>> multi_thread_mail_box_;
+	// if set, then it works with the same multi_thread_mail_box_
+	const std::shared_ptr<WorkStealingPool> work_stealing_pool_;
+
+	struct PriorityLane
+	{
+		std::unique_ptr<MailBox<Runnable>> mail_box_;
+		std::uint32_t weight_;
+	};
+	// Дополнительные почтовые ящики для срочных задач
+	std::vector<PriorityLane> priority_lanes_;
+	const PriorityLanes::Order priority_lanes_order_;
+	const std::uint32_t default_lane_weight_;
+
 	static constexpr std::chrono::nanoseconds permissible_delay_time_{100000000};
 
 	// одноразовый рубильник
 	std::atomic<bool> keep_execution_{true};
+	std::atomic<WaitStrategy> wait_strategy_{WaitStrategy::Block};
+
+#if THREAD_HIGHWAYS_METRICS
+	const std::shared_ptr<Metrics> metrics_{std::make_shared<Metrics>()};
+#endif
 
 	RAIIthread main_thread_;
-	MailBox<Runnable> mail_box_;
+	MainMailBox mail_box_;
 
 private: // main_thread_ thread local:
 	// Запланированные задачи
-	SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack_;
+	ScheduleHeap<Holder<ReschedulableRunnable>> schedule_heap_;
 	// Point in time after which the task should be launched for execution
 	std::chrono::steady_clock::time_point next_schedule_time_{}; // == run if less then now()
+	// WeightedRoundRobin: how many tasks of the main mailbox may be executed before the next round of priority lanes
+	std::uint32_t default_lane_budget_{0u};
+	WorkStealingPool::Worker * work_stealing_worker_{nullptr};
+	// Extra sources of work (see add_input())
+	std::vector<IHighWayInputPtr> inputs_;
 };
 
+using HighWay = BasicHighWay<MailBox<Runnable>>;
+// The main mailbox is a bounded contiguous ring (the capacity can't be changed after the construction)
+using RingHighWay = BasicHighWay<RingMailBox<Runnable>>;
+
 using OnDestroyCallbackPtr = std::function<void()>;
 
 // Proxy защищающий от циклического хранения shared_ptr
@@ -952,6 +1327,98 @@ public:
 		return false;
 	}
 
+	bool execute(const Priority priority, Runnable && runnable) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			highway->execute(priority, std::move(runnable));
+			return true;
+		}
+		return false;
+	}
+
+	template <typename R>
+	bool execute(
+		const Priority priority,
+		R && r,
+		const char * filename = __FILE__,
+		const unsigned int line = __LINE__) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			highway->execute(priority, Runnable::create<R>(std::move(r), filename, line));
+			return true;
+		}
+		return false;
+	}
+
+	template <typename R, typename P>
+	bool execute(const Priority priority, R && r, P protector, const char * filename, const unsigned int line)
+		const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			highway->execute(priority, Runnable::create<R>(std::move(r), std::move(protector), filename, line));
+			return true;
+		}
+		return false;
+	}
+
+	bool try_execute(const Priority priority, Runnable && runnable) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			return highway->try_execute(priority, std::move(runnable));
+		}
+		return false;
+	}
+
+	template <typename R>
+	bool try_execute(
+		const Priority priority,
+		R && r,
+		const char * filename = __FILE__,
+		const unsigned int line = __LINE__) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			return highway->try_execute(priority, Runnable::create<R>(std::move(r), filename, line));
+		}
+		return false;
+	}
+
+	template <typename R, typename P>
+	bool try_execute(const Priority priority, R && r, P protector, const char * filename, const unsigned int line)
+		const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			return highway->try_execute(
+				priority,
+				Runnable::create<R>(std::move(r), std::move(protector), filename, line));
+		}
+		return false;
+	}
+
+	bool execute_batch(std::vector<Runnable> && batch) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			highway->execute_batch(std::move(batch));
+			return true;
+		}
+		return false;
+	}
+
+	bool try_execute_batch(std::vector<Runnable> && batch) const noexcept
+	{
+		if (auto highway = highway_.lock())
+		{
+			return highway->try_execute_batch(std::move(batch));
+		}
+		return false;
+	}
+
 	bool schedule(ReschedulableRunnable && runnable) const noexcept
 	{
 		if (auto highway = highway_.lock())
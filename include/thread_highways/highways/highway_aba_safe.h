@@ -13,6 +13,7 @@
 #include <thread_highways/mailboxes/mail_box_aba_safe.h>
 #include <thread_highways/tools/exception.h>
 #include <thread_highways/tools/raii_thread.h>
+#include <thread_highways/tools/schedule_heap.h>
 #include <thread_highways/tools/stack.h>
 
 #include <chrono>
@@ -232,7 +233,7 @@ private:
 				{
 					next_schedule_time_ = runnable.schedule().next_execution_time_;
 				}
-				schedule_stack_.push(new hi::Holder<ReschedulableRunnable>(std::move(runnable)));
+				schedule_heap_.push(new hi::Holder<ReschedulableRunnable>(std::move(runnable)));
 			});
 	}
 
@@ -259,10 +260,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -276,28 +273,22 @@ private:
 			time = std::chrono::steady_clock::now();
 			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
 		const auto execute_runnable = [&](Runnable & runnable)
@@ -369,10 +360,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -385,28 +372,22 @@ private:
 		{
 			if (before_time >= next_schedule_time_)
 			{
-				next_schedule_time_ = before_time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(before_time))
 				{
-					if (before_time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(before_time + std::chrono::hours{24});
+			} // if (before_time >= next_schedule_time_)
 		};
 
 		const auto execute_runnable = [&](Runnable & runnable)
@@ -477,10 +458,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -494,28 +471,22 @@ private:
 			time = std::chrono::steady_clock::now();
 			if (time >= next_schedule_time_)
 			{
-				next_schedule_time_ = time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(time))
 				{
-					if (time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(time + std::chrono::hours{24});
+			} // if (time >= next_schedule_time_)
 		};
 
 		const auto execute_runnable = [&](Runnable & runnable)
@@ -600,10 +571,6 @@ private:
 
 			if (holder->t_.schedule().rechedule_)
 			{
-				if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-				{
-					next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-				}
 				schedule_stack.push(holder);
 			}
 			else
@@ -616,28 +583,22 @@ private:
 		{
 			if (before_time >= next_schedule_time_)
 			{
-				next_schedule_time_ = before_time + std::chrono::hours{24};
-				while (auto holder = schedule_stack_.pop())
+				// O(log n) per launched task: only the expired tasks are extracted from the heap
+				while (auto holder = schedule_heap_.pop_expired(before_time))
 				{
-					if (before_time >= holder->t_.schedule().next_execution_time_)
-					{
-						execute_reschedulable_runnable(holder);
-					}
-					else
-					{
-						if (next_schedule_time_ > holder->t_.schedule().next_execution_time_)
-						{
-							next_schedule_time_ = holder->t_.schedule().next_execution_time_;
-						}
-						schedule_stack.push(holder);
-					}
+					execute_reschedulable_runnable(holder);
 					if (!keep_execution_.load(std::memory_order_acquire))
 					{
 						return;
 					}
-				} // while schedule_stack_
-				schedule_stack_.swap(schedule_stack);
-			} // if (before_time >=  next_schedule_time_)
+				} // while schedule_heap_
+				// rescheduled tasks return to the heap only after the pass so as not to be launched twice per pass
+				while (auto holder = schedule_stack.pop())
+				{
+					schedule_heap_.push(holder);
+				}
+				next_schedule_time_ = schedule_heap_.next_execution_time(before_time + std::chrono::hours{24});
+			} // if (before_time >= next_schedule_time_)
 		};
 
 		const auto execute_runnable = [&](Runnable & runnable)
@@ -777,7 +738,7 @@ private:
 
 private: // main_thread_ thread local:
 	// Запланированные задачи
-	SingleThreadStack<Holder<ReschedulableRunnable>> schedule_stack_;
+	ScheduleHeap<Holder<ReschedulableRunnable>> schedule_heap_;
 	// Point in time after which the task should be launched for execution
 	std::chrono::steady_clock::time_point next_schedule_time_{}; // == run if less then now()
 };
@@ -3,6 +3,7 @@
 
 #include <thread_highways/highways/highway.h>
 #include <thread_highways/tools/make_self_shared.h>
+#include <thread_highways/tools/metrics.h>
 #include <thread_highways/tools/small_tools.h>
 
 #include <algorithm> // sort
@@ -12,6 +13,17 @@
 namespace hi
 {
 
+// Settings of the highways created by HighWaysManager (HighWaysManager::HighWaySettings)
+struct ManagedHighWaySettings
+{
+	// zero == without time control
+	std::chrono::milliseconds max_task_execution_time_{};
+	std::uint32_t mail_box_capacity_{65000u};
+	// For the mailboxes of the highways and the multi-thread mailbox
+	HoldersReclamation holders_reclamation_{};
+	HoldersAllocation holders_allocation_{};
+};
+
 /*
  * Класс может принимать в работу задачи для размещения на многопоточке
  *  + может выдавать однопоточные хайвеи для использования в однопоточке где-то ещё.
@@ -21,11 +33,7 @@ namespace hi
 class HighWaysManager
 {
 public:
-	struct HighWaySettings
-	{
-		std::chrono::milliseconds max_task_execution_time_;
-		std::uint32_t mail_box_capacity_;
-	};
+	using HighWaySettings = ManagedHighWaySettings;
 
 private:
 	struct HighWayHolder
@@ -52,19 +60,27 @@ public:
 		},
 		std::string highways_manager_name = "HighWaysManager",
 		std::uint32_t multi_thread_mail_box_capacity = 65000u,
-		HighWaySettings highways_settings = HighWaySettings{std::chrono::milliseconds{}, 65000u})
+		HighWaySettings highways_settings = HighWaySettings{},
+		ThreadPlacement thread_placement = {})
 		: self_weak_{std::move(self_weak)}
 		, multi_thread_mail_box_{std::make_shared<MailBox<Runnable>>()}
+		, work_stealing_pool_{std::make_shared<WorkStealingPool>(multi_thread_mail_box_)}
 		, exception_handler_{std::move(exception_handler)}
 		, highways_manager_name_{std::move(highways_manager_name)}
 		, highways_settings_{std::move(highways_settings)}
 		, highways_min_cnt_{highways_min_cnt ? highways_min_cnt : 1u}
 		, auto_regulation_{auto_regulation}
+		, thread_placement_{std::move(thread_placement)}
 	{
 		assert(multi_thread_mail_box_capacity > 0u);
 		assert(highways_settings_.mail_box_capacity_ > 0u);
 
 		multi_thread_mail_box_->set_capacity(multi_thread_mail_box_capacity);
+		multi_thread_mail_box_->set_holders_allocation(highways_settings_.holders_allocation_);
+		multi_thread_mail_box_->set_holders_reclamation(highways_settings_.holders_reclamation_);
+#if THREAD_HIGHWAYS_METRICS
+		multi_thread_mail_box_->set_metrics(std::make_shared<Metrics>());
+#endif
 
 		// Запускаю рабочие потоки которые специализируются только на многопоточке
 		// (предполагается что highways_ могут быть загружены задачами более высокого приоритета,
@@ -133,6 +149,58 @@ public:
 		return get_highway_no_auto_regulation(expected_load_percent);
 	}
 
+	/**
+	 * @brief set_wait_strategy
+	 * What the local workers and the highways do when there are no tasks
+	 * @param wait_strategy - block immediately, spin then park, or busy-poll (for the dedicated cores)
+	 * @note can be changed on the fly
+	 */
+	void set_wait_strategy(const WaitStrategy wait_strategy)
+	{
+		std::lock_guard lg_{mutex_};
+		wait_strategy_.store(wait_strategy, std::memory_order_relaxed);
+		for (auto & it : highways_)
+		{
+			it->highway_->set_wait_strategy(wait_strategy);
+		}
+	}
+
+	/**
+	 * @brief metrics
+	 * Counters of the multi-threaded tasks (executed by the local workers and the highways in their free time).
+	 * Lock-free, can be read from any thread.
+	 * @return only holders_* are filled if THREAD_HIGHWAYS_METRICS is disabled
+	 */
+	MetricsSnapshot metrics() const
+	{
+		MetricsSnapshot re;
+		if (auto metrics = multi_thread_mail_box_->metrics())
+		{
+			re = metrics->snapshot();
+		}
+		re.holders_allocated_ = multi_thread_mail_box_->allocated_holders();
+		re.holders_capacity_ = multi_thread_mail_box_->capacity();
+		re.heap_usage_ = multi_thread_mail_box_->heap_usage();
+		return re;
+	}
+
+	/**
+	 * @brief highways_metrics
+	 * To find the hot highways
+	 * @return metrics of each highway of the manager
+	 */
+	std::vector<MetricsSnapshot> highways_metrics()
+	{
+		std::lock_guard lg_{mutex_};
+		std::vector<MetricsSnapshot> re;
+		re.reserve(highways_.size());
+		for (const auto & it : highways_)
+		{
+			re.emplace_back(it->highway_->metrics());
+		}
+		return re;
+	}
+
 	std::size_t size()
 	{
 		std::lock_guard lg_{mutex_};
@@ -213,6 +281,26 @@ public:
 		return try_execute_impl(Runnable::create<R>(std::move(r), std::move(protector), filename, line));
 	}
 
+	/**
+	 * Setting a batch of tasks for execution with a single publication in the mailbox
+	 *  (one CAS and one wake-up instead of one per task)
+	 * If the holders are over, then the prepared part of the batch is published
+	 *  and it will block in waiting for the holders
+	 *
+	 * @param batch - tasks for execution (will be executed in the order of the vector)
+	 */
+	void execute_batch(std::vector<Runnable> && batch)
+	{
+		multi_thread_mail_box_->send_batch_may_blocked(std::move(batch));
+	}
+
+	// Попытается добавить все задачи разом, если холдеров на весь batch не хватает, то вернёт false
+	// (batch при этом не изменится)
+	bool try_execute_batch(std::vector<Runnable> && batch)
+	{
+		return multi_thread_mail_box_->send_batch_may_fail(std::move(batch));
+	}
+
 private:
 	void destroy()
 	{
@@ -238,12 +326,18 @@ private:
 
 	void execute_impl(Runnable && runnable)
 	{
-		multi_thread_mail_box_->send_may_blocked(std::move(runnable));
+		work_stealing_pool_->execute(std::move(runnable));
 	}
 
 	bool try_execute_impl(Runnable && runnable)
 	{
-		return multi_thread_mail_box_->send_may_fail(std::move(runnable));
+		return work_stealing_pool_->try_execute(std::move(runnable));
+	}
+
+	// Local workers and highways are placed one by one over the cores of the placement
+	ThreadPlacement next_thread_placement()
+	{
+		return placement_for(thread_placement_, placed_threads_++);
 	}
 
 	std::shared_ptr<HighWayHolder> new_holder()
@@ -259,7 +353,13 @@ private:
 			highways_manager_name_,
 			highways_settings_.max_task_execution_time_,
 			highways_settings_.mail_box_capacity_,
-			multi_thread_mail_box_);
+			multi_thread_mail_box_,
+			PriorityLanes{},
+			next_thread_placement(),
+			work_stealing_pool_,
+			highways_settings_.holders_allocation_);
+		highway->set_holders_reclamation(highways_settings_.holders_reclamation_);
+		highway->set_wait_strategy(wait_strategy_.load(std::memory_order_relaxed));
 		return std::make_shared<HighWayHolder>(std::move(highway));
 	}
 
@@ -338,11 +438,12 @@ private:
 		running_local_workers_ += number_of_workers;
 		for (std::uint32_t i = 0; i < number_of_workers; ++i)
 		{
-			local_workers_.emplace_back(RAIIthread(std::thread(
+			local_workers_.emplace_back(start_thread(
+				next_thread_placement(),
 				[this]
 				{
 					worker_loop_without_time_control();
-				})));
+				}));
 		}
 	}
 
@@ -352,6 +453,7 @@ private:
 		{
 			if (!holder)
 				return;
+			const MetricsScope metrics_scope{multi_thread_mail_box_->metrics(), *holder};
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -369,9 +471,11 @@ private:
 		};
 
 		// main loop
+		IdleWaiter idle_waiter{wait_strategy_};
+		WorkStealingPool::Worker worker{*work_stealing_pool_};
 		while (keep_execution_.load(std::memory_order_relaxed))
 		{
-			execute_runnable(multi_thread_mail_box_->pop_message());
+			execute_runnable(worker.pop(idle_waiter, keep_execution_));
 		} // while main loop
 
 		running_local_workers_.fetch_sub(1u, std::memory_order_release);
@@ -382,11 +486,12 @@ private:
 		running_local_workers_ += number_of_workers;
 		for (std::uint32_t i = 0; i < number_of_workers; ++i)
 		{
-			local_workers_.emplace_back(RAIIthread(std::thread(
+			local_workers_.emplace_back(start_thread(
+				next_thread_placement(),
 				[this]
 				{
 					worker_loop_with_time_control();
-				})));
+				}));
 		}
 	}
 
@@ -397,12 +502,17 @@ private:
 							running_local_workers_.fetch_sub(1u, std::memory_order_release);
 						}};
 
-		auto before_time = std::chrono::steady_clock::now();
+		// the stuck tasks are reported by the watchdog while they are still running
+		const auto watched = Watchdog::instance().watch(
+			highways_manager_name_,
+			highways_settings_.max_task_execution_time_,
+			exception_handler_);
 		const auto execute_runnable = [&](Holder<Runnable> * holder)
 		{
 			if (!holder)
 				return;
-			before_time = std::chrono::steady_clock::now();
+			const MetricsScope metrics_scope{multi_thread_mail_box_->metrics(), *holder};
+			watched->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -416,36 +526,33 @@ private:
 				exception_handler_(
 					hi::Exception{highways_manager_name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > highways_settings_.max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					highways_manager_name_ + ":Runnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched->task_finished();
 
 			multi_thread_mail_box_->free_holder(holder);
 		};
 
 		// main loop
+		IdleWaiter idle_waiter{wait_strategy_};
+		WorkStealingPool::Worker worker{*work_stealing_pool_};
 		while (keep_execution_.load(std::memory_order_relaxed))
 		{
-			execute_runnable(multi_thread_mail_box_->pop_message());
+			execute_runnable(worker.pop(idle_waiter, keep_execution_));
 		} // while main loop
 	} // worker_loop_with_time_control
 
 private:
 	const std::weak_ptr<HighWaysManager> self_weak_;
 	const std::shared_ptr<MailBox<Runnable>> multi_thread_mail_box_;
+	// tasks sent from the local workers and highways stay in their deques until stolen
+	const std::shared_ptr<WorkStealingPool> work_stealing_pool_;
 	const ExceptionHandler exception_handler_;
 	const std::string highways_manager_name_;
 	const HighWaySettings highways_settings_;
 	const std::size_t highways_min_cnt_;
 	// Может ли HighWaysManager самостоятельно добавлять/удалять хайвеи
 	const bool auto_regulation_;
+	const ThreadPlacement thread_placement_;
+	std::atomic<std::uint32_t> placed_threads_{0u};
 
 	std::recursive_mutex mutex_;
 	std::vector<std::shared_ptr<HighWayHolder>> highways_;
@@ -455,6 +562,7 @@ private:
 
 	// одноразовый рубильник
 	std::atomic<bool> keep_execution_{true};
+	std::atomic<WaitStrategy> wait_strategy_{WaitStrategy::Block};
 };
 
 } // namespace hi
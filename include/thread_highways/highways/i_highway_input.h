@@ -0,0 +1,47 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_HIGHWAYS_I_HIGHWAY_INPUT_H
+#define THREADS_HIGHWAYS_HIGHWAYS_I_HIGHWAY_INPUT_H
+
+#include <atomic>
+#include <memory>
+
+namespace hi
+{
+
+/**
+ * @brief IHighWayInput
+ * Extra source of work for the highway besides its mailboxes (SpscChannel for example):
+ *  polled by the highway thread between the tasks.
+ * Whoever puts work into the input must wake the highway (HighWay::wake()).
+ */
+struct IHighWayInput
+{
+	virtual ~IHighWayInput() = default;
+
+	/**
+	 * @brief execute
+	 * Highway thread: executing a batch of the pending work
+	 * @param keep_execution - the highway is being destroyed if false
+	 * @return false if the input is closed and drained (the highway forgets it)
+	 */
+	virtual bool execute(const std::atomic<bool> & keep_execution) = 0;
+
+	// Highway thread: there is work (or the input was closed)
+	[[nodiscard]] virtual bool has_work() const noexcept = 0;
+
+	// Where the input was created (for the reports of the exception handler and the watchdog)
+	[[nodiscard]] virtual const char * get_code_filename() const noexcept = 0;
+	[[nodiscard]] virtual unsigned int get_code_line() const noexcept = 0;
+};
+
+using IHighWayInputPtr = std::shared_ptr<IHighWayInput>;
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_HIGHWAYS_I_HIGHWAY_INPUT_H
@@ -11,8 +11,11 @@
 #include <thread_highways/execution_tree/runnable.h>
 #include <thread_highways/mailboxes/mail_box.h>
 #include <thread_highways/tools/exception.h>
+#include <thread_highways/tools/metrics.h>
 #include <thread_highways/tools/raii_thread.h>
 #include <thread_highways/tools/small_tools.h>
+#include <thread_highways/tools/thread_placement.h>
+#include <thread_highways/tools/watchdog.h>
 
 #include <future>
 #include <vector>
@@ -34,22 +37,26 @@ public:
 		},
 		std::string name = "MultiThreadedTaskProcessingPlant",
 		std::chrono::milliseconds max_task_execution_time = {},
-		const std::uint32_t mail_box_capacity = 65000u)
+		const std::uint32_t mail_box_capacity = 65000u,
+		ThreadPlacement thread_placement = {})
 		: exception_handler_{std::move(exception_handler)}
 		, name_{std::move(name)}
 		, max_task_execution_time_{max_task_execution_time}
 	{
 		set_capacity(mail_box_capacity);
+#if THREAD_HIGHWAYS_METRICS
+		mail_box_.set_metrics(metrics_);
+#endif
 		if (number_of_workers < 1)
 			number_of_workers = 1;
 
 		if (max_task_execution_time_ == std::chrono::milliseconds{})
 		{
-			start_workers_without_time_control(self_weak.lock(), number_of_workers);
+			start_workers_without_time_control(self_weak.lock(), number_of_workers, thread_placement);
 		}
 		else
 		{
-			start_workers_with_time_control(self_weak.lock(), number_of_workers);
+			start_workers_with_time_control(self_weak.lock(), number_of_workers, thread_placement);
 		}
 	}
 
@@ -61,6 +68,46 @@ public:
 		}
 	}
 
+	/**
+	 * @brief set_holders_reclamation
+	 * Returning the holders left after a burst to the heap
+	 * @param reclamation - low watermark and cool down
+	 * @note must be called right after the creation of the plant (before the tasks are sent), zero cool_down_ turns it off at any time
+	 */
+	void set_holders_reclamation(const HoldersReclamation & reclamation)
+	{
+		mail_box_.set_holders_reclamation(reclamation);
+	}
+
+	/**
+	 * @brief set_wait_strategy
+	 * What the workers do when there are no tasks
+	 * @param wait_strategy - block immediately, spin then park, or busy-poll (for the dedicated cores)
+	 * @note can be changed on the fly
+	 */
+	void set_wait_strategy(const WaitStrategy wait_strategy)
+	{
+		wait_strategy_.store(wait_strategy, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief metrics
+	 * Counters of the tasks sent to this plant.
+	 * Lock-free, can be read from any thread.
+	 * @return only holders_* are filled if THREAD_HIGHWAYS_METRICS is disabled
+	 */
+	MetricsSnapshot metrics() const
+	{
+		MetricsSnapshot re;
+#if THREAD_HIGHWAYS_METRICS
+		re = metrics_->snapshot();
+#endif
+		re.holders_allocated_ = mail_box_.allocated_holders();
+		re.holders_capacity_ = mail_box_.capacity();
+		re.heap_usage_ = mail_box_.heap_usage();
+		return re;
+	}
+
 	// Будет пытаться добавить задачу, если ресурсов не осталось то заблокируется в ожидании
 	void execute(Runnable && runnable)
 	{
@@ -135,6 +182,26 @@ public:
 		return try_execute_impl(Runnable::create<R>(std::move(r), std::move(protector), filename, line));
 	}
 
+	/**
+	 * Setting a batch of tasks for execution with a single publication in the mailbox
+	 *  (one CAS and one wake-up instead of one per task)
+	 * If the holders are over, then the prepared part of the batch is published
+	 *  and it will block in waiting for the holders
+	 *
+	 * @param batch - tasks for execution (will be executed in the order of the vector)
+	 */
+	void execute_batch(std::vector<Runnable> && batch)
+	{
+		mail_box_.send_batch_may_blocked(std::move(batch));
+	}
+
+	// Попытается добавить все задачи разом, если холдеров на весь batch не хватает, то вернёт false
+	// (batch при этом не изменится)
+	bool try_execute_batch(std::vector<Runnable> && batch)
+	{
+		return mail_box_.send_batch_may_fail(std::move(batch));
+	}
+
 	void destroy()
 	{
 		keep_execution_.store(false, std::memory_order_release);
@@ -158,15 +225,17 @@ private:
 
 	void start_workers_without_time_control(
 		const std::shared_ptr<MultiThreadedTaskProcessingPlant> self_protector,
-		std::uint32_t number_of_workers)
+		std::uint32_t number_of_workers,
+		const ThreadPlacement & thread_placement)
 	{
 		for (std::uint32_t i = 0; i < number_of_workers; ++i)
 		{
-			workers_.emplace_back(RAIIthread(std::thread(
+			workers_.emplace_back(start_thread(
+				placement_for(thread_placement, i),
 				[this, self_protector]
 				{
 					worker_loop_without_time_control(self_protector);
-				})));
+				}));
 		}
 	}
 
@@ -176,6 +245,7 @@ private:
 		{
 			if (!holder)
 				return;
+			const MetricsScope metrics_scope{mail_box_.metrics(), *holder};
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -192,9 +262,10 @@ private:
 		};
 
 		// main loop
+		IdleWaiter idle_waiter{wait_strategy_};
 		while (keep_execution_.load(std::memory_order_relaxed))
 		{
-			execute_runnable(mail_box_.pop_message());
+			execute_runnable(mail_box_.pop_message(idle_waiter));
 		} // while main loop
 
 		self_protector->keep_execution_ = false;
@@ -202,15 +273,17 @@ private:
 
 	void start_workers_with_time_control(
 		const std::shared_ptr<MultiThreadedTaskProcessingPlant> self_protector,
-		std::uint32_t number_of_workers)
+		std::uint32_t number_of_workers,
+		const ThreadPlacement & thread_placement)
 	{
 		for (std::uint32_t i = 0; i < number_of_workers; ++i)
 		{
-			workers_.emplace_back(RAIIthread(std::thread(
+			workers_.emplace_back(start_thread(
+				placement_for(thread_placement, i),
 				[this, self_protector]
 				{
 					worker_loop_with_time_control(self_protector);
-				})));
+				}));
 		}
 	}
 
@@ -221,12 +294,14 @@ private:
 							self_protector->keep_execution_ = false;
 						}};
 
-		auto before_time = std::chrono::steady_clock::now();
+		// the stuck tasks are reported by the watchdog while they are still running
+		const auto watched = Watchdog::instance().watch(name_, max_task_execution_time_, exception_handler_);
 		const auto execute_runnable = [&](Holder<Runnable> * holder)
 		{
 			if (!holder)
 				return;
-			before_time = std::chrono::steady_clock::now();
+			const MetricsScope metrics_scope{mail_box_.metrics(), *holder};
+			watched->task_started(holder->t_.get_code_filename(), holder->t_.get_code_line());
 			try
 			{
 				holder->t_.run(keep_execution_);
@@ -239,24 +314,16 @@ private:
 			{
 				exception_handler_(hi::Exception{name_ + ": ", __FILE__, __LINE__, std::current_exception()});
 			}
-			const auto after_time = std::chrono::steady_clock::now();
-			const auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(after_time - before_time);
-			before_time = after_time;
-			if (time_diff > max_task_execution_time_)
-			{
-				exception_handler_(hi::Exception{
-					name_ + ":Runnable:stuck for ms = " + std::to_string(time_diff.count()),
-					holder->t_.get_code_filename(),
-					holder->t_.get_code_line()});
-			}
+			watched->task_finished();
 
 			mail_box_.free_holder(holder);
 		};
 
 		// main loop
+		IdleWaiter idle_waiter{wait_strategy_};
 		while (keep_execution_.load(std::memory_order_relaxed))
 		{
-			execute_runnable(mail_box_.pop_message());
+			execute_runnable(mail_box_.pop_message(idle_waiter));
 		} // while main loop
 	} // worker_loop_with_time_control
 
@@ -265,11 +332,16 @@ private:
 	const std::string name_;
 	const std::chrono::milliseconds max_task_execution_time_;
 
+#if THREAD_HIGHWAYS_METRICS
+	const std::shared_ptr<Metrics> metrics_{std::make_shared<Metrics>()};
+#endif
+
 	std::vector<RAIIthread> workers_;
 	MailBox<Runnable> mail_box_;
 
 	// одноразовый рубильник
 	std::atomic<bool> keep_execution_{true};
+	std::atomic<WaitStrategy> wait_strategy_{WaitStrategy::Block};
 };
 
 } // namespace hi
@@ -0,0 +1,58 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_HIGHWAYS_PRIORITY_LANES_H
+#define THREADS_HIGHWAYS_HIGHWAYS_PRIORITY_LANES_H
+
+#include <cstdint>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief Priority
+ * Priority of a task on the HighWay.
+ * Priority::Default is the main mailbox of the HighWay (execute() without priority),
+ * Priority{i} (i > 0) is the priority lane i - 1: the greater the priority, the more urgent the task.
+ */
+enum class Priority : std::uint32_t
+{
+	Default = 0
+};
+
+/**
+ * @brief PriorityLanes
+ * Additional mailboxes of the HighWay for the urgent tasks
+ * (so that urgent control messages do not queue behind thousands of bulk tasks).
+ */
+struct PriorityLanes
+{
+	enum class Order : std::uint8_t
+	{
+		// The most urgent non-empty lane is always executed first (the lower lanes may starve)
+		Strict,
+		// Each round executes up to weight_ tasks from each lane (the most urgent first)
+		// and up to default_lane_weight_ tasks from the main mailbox
+		WeightedRoundRobin
+	};
+
+	struct Lane
+	{
+		std::uint32_t capacity_{65000u};
+		std::uint32_t weight_{1u};
+	};
+
+	Order order_{Order::Strict};
+	std::uint32_t default_lane_weight_{1u};
+	// lanes_[0] is Priority{1}, lanes_[1] is Priority{2} and so on
+	std::vector<Lane> lanes_;
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_HIGHWAYS_PRIORITY_LANES_H
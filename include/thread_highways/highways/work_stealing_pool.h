@@ -0,0 +1,268 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_HIGHWAYS_WORK_STEALING_POOL_H
+#define THREADS_HIGHWAYS_HIGHWAYS_WORK_STEALING_POOL_H
+
+#include <thread_highways/execution_tree/runnable.h>
+#include <thread_highways/mailboxes/mail_box.h>
+#include <thread_highways/tools/wait_strategy.h>
+#include <thread_highways/tools/work_stealing_deque.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief WorkStealingPool
+ * Multi-threaded work shared by the workers of HighWaysManager (local workers and highways):
+ *  - each worker has its own Chase-Lev deque, the tasks sent from a worker go there
+ *    (no CAS on the shared mailbox, the recently created tasks are hot in the cache);
+ *  - the tasks sent from the other threads go to the shared mailbox;
+ *  - a worker without tasks steals from a random worker before falling asleep.
+ * Holders are taken from the shared mailbox, so its capacity limits all the tasks of the pool.
+ */
+class WorkStealingPool
+{
+	struct Slot
+	{
+		WorkStealingDeque<Holder<Runnable>> deque_;
+		bool busy_{false}; // guarded by mutex_
+	};
+
+	// Worker of which pool is the current thread
+	struct Current
+	{
+		WorkStealingPool * pool_;
+		Slot * slot_;
+	};
+
+public:
+	static constexpr std::uint32_t max_workers_{256u};
+
+	explicit WorkStealingPool(std::shared_ptr<MailBox<Runnable>> mail_box)
+		: mail_box_{std::move(mail_box)}
+	{
+	}
+
+	WorkStealingPool(const WorkStealingPool &) = delete;
+	WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+	~WorkStealingPool()
+	{
+		// the tasks that were not executed release their captures
+		for (auto & slot : slots_owner_)
+		{
+			while (auto holder = slot->deque_.steal())
+			{
+				mail_box_->free_holder(holder);
+			}
+		}
+	}
+
+	/**
+	 * @brief Worker
+	 * Membership of the calling thread in the pool (for the lifetime of the object)
+	 */
+	class Worker
+	{
+	public:
+		explicit Worker(WorkStealingPool & pool)
+			: pool_{pool}
+			, slot_{pool.join()}
+			, previous_{current_}
+		{
+			current_ = Current{&pool_, slot_};
+		}
+
+		~Worker()
+		{
+			current_ = previous_;
+			pool_.leave(slot_);
+		}
+
+		Worker(const Worker &) = delete;
+		Worker & operator=(const Worker &) = delete;
+
+		/**
+		 * @brief pop_no_wait
+		 * Own deque, then the shared mailbox, then stealing
+		 * @return holder or nullptr
+		 */
+		[[nodiscard]] Holder<Runnable> * pop_no_wait()
+		{
+			return pool_.pop_no_wait(slot_);
+		}
+
+		/**
+		 * @brief pop
+		 * Like pop_no_wait(), but falls asleep if there is no work anywhere
+		 * @return holder or nullptr if keep_execution became false
+		 */
+		[[nodiscard]] Holder<Runnable> * pop(IdleWaiter & idle_waiter, const std::atomic<bool> & keep_execution)
+		{
+			while (keep_execution.load(std::memory_order_relaxed))
+			{
+				if (auto holder = pool_.pop_no_wait(slot_))
+					return holder;
+				if (auto holder = pool_.mail_box_->pop_message(
+						idle_waiter,
+						[this]
+						{
+							return pool_.has_stealable_work();
+						}))
+					return holder;
+			}
+			return nullptr;
+		}
+
+	private:
+		WorkStealingPool & pool_;
+		Slot * const slot_;
+		const Current previous_;
+	};
+
+	// Will block if there are no free holders
+	void execute(Runnable && runnable)
+	{
+		if (push_local(runnable))
+			return;
+		mail_box_->send_may_blocked(std::move(runnable));
+	}
+
+	// May fail if there are no free holders
+	bool try_execute(Runnable && runnable)
+	{
+		if (push_local(runnable))
+			return true;
+		return mail_box_->send_may_fail(std::move(runnable));
+	}
+
+	// There are tasks in the deques of the workers
+	[[nodiscard]] bool has_stealable_work() const noexcept
+	{
+		const auto cnt = slots_cnt_.load(std::memory_order_acquire);
+		for (std::uint32_t i = 0; i < cnt; ++i)
+		{
+			if (!slots_[i].load(std::memory_order_acquire)->deque_.empty())
+				return true;
+		}
+		return false;
+	}
+
+private:
+	Slot * join()
+	{
+		std::lock_guard lg{mutex_};
+		for (auto & slot : slots_owner_)
+		{
+			if (!slot->busy_)
+			{
+				// the tasks left by the previous owner are now ours
+				slot->busy_ = true;
+				return slot.get();
+			}
+		}
+		if (slots_owner_.size() == max_workers_)
+			return nullptr; // works with the shared mailbox only
+
+		slots_owner_.emplace_back(std::make_unique<Slot>());
+		Slot * re = slots_owner_.back().get();
+		re->busy_ = true;
+		slots_[slots_owner_.size() - 1u].store(re, std::memory_order_release);
+		slots_cnt_.store(static_cast<std::uint32_t>(slots_owner_.size()), std::memory_order_release);
+		return re;
+	}
+
+	void leave(Slot * slot)
+	{
+		if (!slot)
+			return;
+		{
+			std::lock_guard lg{mutex_};
+			slot->busy_ = false;
+		}
+		// the tasks left in the deque must not wait for the next owner
+		if (!slot->deque_.empty())
+		{
+			mail_box_->wake();
+		}
+	}
+
+	bool push_local(Runnable & runnable)
+	{
+		if (current_.pool_ != this || !current_.slot_)
+			return false;
+		auto holder = mail_box_->pack_may_fail(std::move(runnable));
+		if (!holder)
+			return false;
+		current_.slot_->deque_.push(holder);
+		// the sleeping workers may steal it
+		mail_box_->wake();
+		return true;
+	}
+
+	Holder<Runnable> * pop_no_wait(Slot * own)
+	{
+		if (own)
+		{
+			if (auto holder = own->deque_.pop())
+				return holder;
+		}
+		if (auto holder = mail_box_->pop_message_no_wait())
+			return holder;
+		return steal(own);
+	}
+
+	Holder<Runnable> * steal(Slot * own)
+	{
+		const auto cnt = slots_cnt_.load(std::memory_order_acquire);
+		if (!cnt)
+			return nullptr;
+		const auto start = next_random() % cnt;
+		for (std::uint32_t i = 0; i < cnt; ++i)
+		{
+			Slot * victim = slots_[(start + i) % cnt].load(std::memory_order_acquire);
+			if (victim == own)
+				continue;
+			if (auto holder = victim->deque_.steal())
+				return holder;
+		}
+		return nullptr;
+	}
+
+	static std::uint32_t next_random() noexcept
+	{
+		// xorshift32
+		thread_local std::uint32_t state{
+			static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state) >> 4u) | 1u};
+		state ^= state << 13u;
+		state ^= state >> 17u;
+		state ^= state << 5u;
+		return state;
+	}
+
+private:
+	inline static thread_local Current current_{nullptr, nullptr};
+
+	const std::shared_ptr<MailBox<Runnable>> mail_box_;
+
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<Slot>> slots_owner_; // guarded by mutex_
+	std::array<std::atomic<Slot *>, max_workers_> slots_{};
+	std::atomic<std::uint32_t> slots_cnt_{0u};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_HIGHWAYS_WORK_STEALING_POOL_H
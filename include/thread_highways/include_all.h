@@ -15,6 +15,7 @@
 #include <thread_highways/channels/highway_sticky_publisher_with_connections_notifier.h>
 #include <thread_highways/channels/publish_many_for_one.h>
 #include <thread_highways/channels/publish_one_for_many.h>
+#include <thread_highways/channels/spsc_channel.h>
 
 #include <thread_highways/execution_tree/default_execution_tree.h>
 #include <thread_highways/execution_tree/future.h>
@@ -8,16 +8,23 @@
 #ifndef THREADS_HIGHWAYS_MAILBOXES_MAIL_BOX_H
 #define THREADS_HIGHWAYS_MAILBOXES_MAIL_BOX_H
 
+#include <thread_highways/tools/epoch_reclamation.h>
+#include <thread_highways/tools/event_count.h>
 #include <thread_highways/tools/exception.h>
-#include <thread_highways/tools/semaphore.h>
+#include <thread_highways/tools/holders_reclaimer.h>
+#include <thread_highways/tools/holders_slab.h>
+#include <thread_highways/tools/metrics.h>
 #include <thread_highways/tools/stack.h>
+#include <thread_highways/tools/wait_strategy.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <thread>
+#include <vector>
 
 namespace hi
 {
@@ -26,13 +33,43 @@ namespace hi
  * @brief MailBox
  * Thread-safe mutexless mailbox with control over the total number of holders.
  * Holder is a container for your message to be added to the message queue.
+ * Event - how the waiting threads are woken up (EventCount or Semaphore).
  *
  * Usage example: https://github.com/DimaBond174/thread_highways/blob/main/include/thread_highways/highways/IHighWay.h
  */
-template <typename T>
+template <typename T, typename Event = EventCount>
 class MailBox
 {
 public:
+	// What the consumer extracts the messages to with move_to()
+	using WorkQueue = SingleThreadStack<Holder<T>>;
+
+	static constexpr std::uint32_t default_capacity_{1024u};
+
+	MailBox() = default;
+
+	explicit MailBox(const std::uint32_t capacity)
+		: capacity_{capacity}
+	{
+	}
+
+	MailBox(const std::uint32_t capacity, const HoldersAllocation & holders_allocation)
+		: capacity_{capacity}
+	{
+		set_holders_allocation(holders_allocation);
+	}
+
+	MailBox(const MailBox &) = delete;
+	MailBox & operator=(const MailBox &) = delete;
+
+	~MailBox()
+	{
+		if (reclamation_ticket_)
+		{
+			reclamation_ticket_->cancel();
+		}
+	}
+
 	/**
 	 * @brief set_capacity
 	 * Setting the maximum number of holders in operation.
@@ -42,17 +79,154 @@ public:
 	void set_capacity(const std::uint32_t capacity)
 	{
 		capacity_.store(capacity, std::memory_order_release);
+		empty_holders_event_.signal_to_all();
 	}
 
-	void move_to(SingleThreadStack<Holder<T>> & work_queue, std::chrono::nanoseconds max_wait)
+	/**
+	 * @brief set_metrics
+	 * Attaching the counters: sent/dropped messages are counted by the mailbox,
+	 *  executed ones - by the consumer (see MetricsScope)
+	 * @param metrics - may be shared by several mailboxes
+	 * @note does nothing if the metrics are disabled (THREAD_HIGHWAYS_METRICS)
+	 */
+	void set_metrics([[maybe_unused]] std::shared_ptr<Metrics> metrics)
+	{
+#if THREAD_HIGHWAYS_METRICS
+		metrics_ = std::move(metrics);
+#endif
+	}
+
+	// nullptr if there are no metrics
+	[[nodiscard]] Metrics * metrics() const noexcept
+	{
+#if THREAD_HIGHWAYS_METRICS
+		return metrics_.get();
+#else
+		return nullptr;
+#endif
+	}
+
+	[[nodiscard]] std::uint32_t capacity() const noexcept
+	{
+		return capacity_.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] std::uint32_t allocated_holders() const noexcept
+	{
+		return allocated_holders_.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief heap_usage
+	 * @return bytes taken by the holders (including the freed ones that are not yet deleted)
+	 * @note a slab of holders is returned to the OS with the last of its holders
+	 */
+	[[nodiscard]] std::uint64_t heap_usage() const noexcept
+	{
+		const auto holders = std::uint64_t{allocated_holders_.load(std::memory_order_relaxed)} + epochs_.retired_cnt();
+		if (slab_size_)
+			return slabs_footprint<T>(holders, slab_size_, huge_pages_);
+		return holders * holder_footprint<T>(false);
+	}
+
+	/**
+	 * @brief set_holders_reclamation
+	 * Returning the holders left after a burst to the heap:
+	 *  every cool_down the holders that stayed free since the previous check are deleted
+	 *  (but no more than the allocated_holders() - low_watermark).
+	 * The pops from the shared stacks pin an epoch while the reclamation is on (EpochReclamation),
+	 *  so a deleted holder can't be read by a frozen pop() - no ABA/use-after-free.
+	 * @param reclamation - zero cool_down_ turns the reclamation off: the pops stop pinning
+	 * @note must be called before the mailbox is used (before the first message is sent),
+	 *  turning the reclamation off is allowed at any time
+	 */
+	void set_holders_reclamation(const HoldersReclamation & reclamation)
+	{
+		if (reclamation.cool_down_.count() <= 0)
+		{
+			stop_holders_reclamation();
+			return;
+		}
+		if (reclamation_ticket_)
+			return;
+		low_watermark_ = reclamation.low_watermark_;
+		reclamation_enabled_.store(true, std::memory_order_seq_cst);
+		reclamation_ticket_ = HoldersReclaimer::instance().add(
+			reclamation.cool_down_,
+			[this]
+			{
+				reclaim_holders();
+			});
+	}
+
+	/**
+	 * @brief set_holders_allocation
+	 * Allocating the holders by contiguous slabs instead of one by one (and/or all of them at once)
+	 * @param holders_allocation - if prefault_, then reserve_holders() is called right now
+	 * @note must be called before the mailbox is used (before the first message is sent)
+	 */
+	void set_holders_allocation(const HoldersAllocation & holders_allocation)
+	{
+		if constexpr (SlabHolders<T>::value && alignof(Holder<T>) <= 64u)
+		{
+			slab_size_ = holders_allocation.slab_size_ > 1u ? holders_allocation.slab_size_ : 0u;
+		}
+		huge_pages_ = holders_allocation.huge_pages_;
+		if (holders_allocation.prefault_)
+		{
+			reserve_holders();
+		}
+	}
+
+	/**
+	 * @brief reserve_holders
+	 * Allocating all the holders up to the capacity right now in the calling thread
+	 * (the memory is first touched by this thread => it's placed on the NUMA node of this thread)
+	 */
+	void reserve_holders()
 	{
-		if (!messages_stack_.access_stack())
+		while (Holder<T> * first = allocate_holders())
 		{
-			messages_stack_semaphore_.wait_for(max_wait);
+			push_free_chain(first);
 		}
+		empty_holders_event_.signal_to_all();
+	}
+
+	void move_to(SingleThreadStack<Holder<T>> & work_queue, std::chrono::nanoseconds max_wait)
+	{
+		messages_stack_event_.wait_for(
+			[this]
+			{
+				return !!messages_stack_.access_stack();
+			},
+			max_wait);
+		messages_stack_.move_to(work_queue);
+	}
+
+	/**
+	 * @brief move_to
+	 * Waiting for the messages or for the wake_condition
+	 * @param wake_condition - one more reason to stop waiting (messages in other mailboxes, for example).
+	 *  Whoever makes it true must call wake()
+	 */
+	template <typename Condition>
+	void move_to(SingleThreadStack<Holder<T>> & work_queue, std::chrono::nanoseconds max_wait, Condition && wake_condition)
+	{
+		messages_stack_event_.wait_for(
+			[&]
+			{
+				return messages_stack_.access_stack() || wake_condition();
+			},
+			max_wait);
 		messages_stack_.move_to(work_queue);
 	}
 
+	// Wakes up the consumer waiting in move_to() with wake_condition
+	void wake()
+	{
+		messages_stack_event_.signal();
+	}
+
 	void move_to_no_wait(SingleThreadStack<Holder<T>> & work_queue)
 	{
 		messages_stack_.move_to(work_queue);
@@ -66,15 +240,89 @@ public:
 	 */
 	[[nodiscard]] Holder<T> * pop_message()
 	{
-		Holder<T> * re = work_queue_.pop();
+		Holder<T> * re = pinned_pop(work_queue_);
 		while (!re && keep_execution_.load(std::memory_order_acquire))
 		{
-			if (!messages_stack_.access_stack())
+			messages_stack_event_.wait(
+				[this]
+				{
+					return messages_stack_.access_stack() || work_queue_.access_stack()
+						|| !keep_execution_.load(std::memory_order_acquire);
+				});
+			messages_stack_.move_to(work_queue_);
+			re = pinned_pop(work_queue_);
+		}
+		if (re && work_queue_.access_stack())
+		{
+			// there is more work for the other consumers
+			messages_stack_event_.signal();
+		}
+		return re;
+	}
+
+	/**
+	 * @brief pop_message
+	 * Extracting one holder with a message.
+	 * Do not use it with move_to();
+	 * @param idle_waiter - how to wait if empty (spin before falling asleep or not)
+	 * @return holder or nullptr
+	 */
+	[[nodiscard]] Holder<T> * pop_message(IdleWaiter & idle_waiter)
+	{
+		Holder<T> * re = pinned_pop(work_queue_);
+		while (!re && keep_execution_.load(std::memory_order_acquire))
+		{
+			const auto has_work = [this]
+			{
+				return messages_stack_.access_stack() || work_queue_.access_stack()
+					|| !keep_execution_.load(std::memory_order_acquire);
+			};
+			if (!idle_waiter.spin(has_work, std::chrono::steady_clock::time_point::max()))
 			{
-				messages_stack_semaphore_.wait();
+				messages_stack_event_.wait(has_work);
 			}
 			messages_stack_.move_to(work_queue_);
-			re = work_queue_.pop();
+			re = pinned_pop(work_queue_);
+		}
+		if (re && work_queue_.access_stack())
+		{
+			// there is more work for the other consumers
+			messages_stack_event_.signal();
+		}
+		return re;
+	}
+
+	/**
+	 * @brief pop_message
+	 * Extracting one holder with a message.
+	 * Do not use it with move_to();
+	 * @param idle_waiter - how to wait if empty (spin before falling asleep or not)
+	 * @param wake_condition - one more reason to stop waiting (work in other queues, for example).
+	 *  Whoever makes it true must call wake()
+	 * @return holder or nullptr (if woken up by the wake_condition)
+	 */
+	template <typename Condition>
+	[[nodiscard]] Holder<T> * pop_message(IdleWaiter & idle_waiter, Condition && wake_condition)
+	{
+		Holder<T> * re = pinned_pop(work_queue_);
+		if (!re && keep_execution_.load(std::memory_order_acquire))
+		{
+			const auto has_work = [&]
+			{
+				return messages_stack_.access_stack() || work_queue_.access_stack() || wake_condition()
+					|| !keep_execution_.load(std::memory_order_acquire);
+			};
+			if (!idle_waiter.spin(has_work, std::chrono::steady_clock::time_point::max()))
+			{
+				messages_stack_event_.wait(has_work);
+			}
+			messages_stack_.move_to(work_queue_);
+			re = pinned_pop(work_queue_);
+		}
+		if (re && work_queue_.access_stack())
+		{
+			// there is more work for the other consumers
+			messages_stack_event_.signal();
 		}
 		return re;
 	}
@@ -88,27 +336,32 @@ public:
 	 */
 	[[nodiscard]] Holder<T> * pop_message_no_wait()
 	{
-		Holder<T> * re = work_queue_.pop();
+		Holder<T> * re = pinned_pop(work_queue_);
 		if (!re)
 		{
 			messages_stack_.move_to(work_queue_);
-			re = work_queue_.pop();
+			re = pinned_pop(work_queue_);
 		}
 		return re;
 	}
 
+	// There are messages waiting to be extracted
+	[[nodiscard]] bool has_messages() const noexcept
+	{
+		return messages_stack_.access_stack() || work_queue_.access_stack();
+	}
+
 	/**
 	 * @brief free_holder
 	 * Returning a holder to the pool of released holders.
 	 * @param holder
-	 * @note for those who are waiting for the release
-	 * of holders on the semaphore gives a signal
+	 * @note wakes up the one waiting for the release of holders (if any)
 	 */
 	void free_holder(Holder<T> * holder)
 	{
 		holder->t_.clear();
 		empty_holders_stack_.push(holder);
-		empty_holders_stack_semaphore_.signal();
+		empty_holders_event_.signal();
 	}
 
 	/**
@@ -118,8 +371,8 @@ public:
 	void destroy()
 	{
 		keep_execution_.store(false, std::memory_order_release);
-		empty_holders_stack_semaphore_.destroy();
-		messages_stack_semaphore_.destroy();
+		empty_holders_event_.destroy();
+		messages_stack_event_.destroy();
 	}
 
 public: // IMailBoxSendHere
@@ -134,22 +387,178 @@ public: // IMailBoxSendHere
 	{
 		Holder<T> * holder = aba_safe_get_free_holder();
 		if (!holder)
+		{
+			on_dropped(1u);
 			return false; // may_fail
+		}
 		holder->t_ = std::move(t);
 
+		on_sent(holder, holder);
 		messages_stack_.push(holder);
-		messages_stack_semaphore_.signal_keep_one();
+		messages_stack_event_.signal_keep_one();
 		return true;
 	}
 
 	/**
 	 * @brief send_may_blocked
 	 * Passing the message object to the mailbox for storage.
-	 * If the holders are over, then it will block on the semaphore
+	 * If the holders are over, then it will block on the event
 	 *  and will wait for the holders to become free.
 	 * @param t - message object
 	 */
 	void send_may_blocked(T && t)
+	{
+		Holder<T> * holder = get_free_holder_may_blocked();
+		if (!holder)
+		{
+			return; // keep_execution_ был сброшен
+		}
+
+		holder->t_ = std::move(t);
+		on_sent(holder, holder);
+		messages_stack_.push(holder);
+		messages_stack_event_.signal_keep_one();
+	}
+
+	/**
+	 * @brief pack_may_fail
+	 * Putting the message object into a holder without sending it
+	 *  (for the queues outside the mailbox, work stealing deques for example).
+	 * The holder counts against the capacity and must be returned with free_holder()
+	 * @param t - message object (stays untouched if failed)
+	 * @return holder or nullptr if holders run out
+	 */
+	[[nodiscard]] Holder<T> * pack_may_fail(T && t)
+	{
+		Holder<T> * holder = aba_safe_get_free_holder();
+		if (!holder)
+			return nullptr;
+		holder->t_ = std::move(t);
+		on_sent(holder, holder);
+		return holder;
+	}
+
+	/**
+	 * @brief send_batch_may_fail
+	 * Passing a batch of message objects to the mailbox with a single publication
+	 *  (one CAS on the messages stack and one wake-up of the consumer).
+	 * All or nothing: if there are not enough holders for the whole batch,
+	 *  then nothing is sent and the batch stays untouched.
+	 * @param batch - message objects (in the order of execution)
+	 * @return true if the send was successful
+	 */
+	bool send_batch_may_fail(std::vector<T> && batch)
+	{
+		Holder<T> * first{nullptr};
+		Holder<T> * last{nullptr};
+		for (std::size_t i = 0; i < batch.size(); ++i)
+		{
+			Holder<T> * holder = aba_safe_get_free_holder();
+			if (!holder)
+			{
+				while (first)
+				{
+					Holder<T> * next = first->next_in_stack_;
+					empty_holders_stack_.push(first);
+					first = next;
+				}
+				empty_holders_event_.signal();
+				on_dropped(batch.size());
+				return false; // may_fail
+			}
+			holder->next_in_stack_ = first;
+			first = holder;
+			if (!last)
+				last = holder;
+		}
+
+		// The head of the chain gets the last message (the stack is unrolled on the consumer side)
+		Holder<T> * holder = first;
+		for (auto it = batch.rbegin(); it != batch.rend(); ++it, holder = holder->next_in_stack_)
+		{
+			holder->t_ = std::move(*it);
+		}
+		publish_chain(first, last);
+		return true;
+	}
+
+	/**
+	 * @brief send_batch_may_blocked
+	 * Passing a batch of message objects to the mailbox with a single publication
+	 *  (one CAS on the messages stack and one wake-up of the consumer).
+	 * If the holders are over, then the already filled part of the batch is published
+	 *  and it will block on the event until the holders become free.
+	 * @param batch - message objects (in the order of execution)
+	 */
+	void send_batch_may_blocked(std::vector<T> && batch)
+	{
+		Holder<T> * first{nullptr};
+		Holder<T> * last{nullptr};
+		for (auto && t : batch)
+		{
+			Holder<T> * holder = aba_safe_get_free_holder();
+			if (!holder)
+			{
+				// the consumer must not wait for the holders kept by this chain
+				publish_chain(first, last);
+				first = last = nullptr;
+				holder = get_free_holder_may_blocked();
+				if (!holder)
+				{
+					return; // keep_execution_ был сброшен
+				}
+			}
+			holder->t_ = std::move(t);
+			holder->next_in_stack_ = first;
+			first = holder;
+			if (!last)
+				last = holder;
+		}
+		publish_chain(first, last);
+	}
+
+private:
+	void on_sent([[maybe_unused]] Holder<T> * first, [[maybe_unused]] Holder<T> * last) noexcept
+	{
+#if THREAD_HIGHWAYS_METRICS
+		if (!metrics_)
+			return;
+		const auto now = std::chrono::steady_clock::now();
+		std::uint64_t cnt{1u};
+		for (; first != last; first = first->next_in_stack_, ++cnt)
+		{
+			first->sent_at_ = now;
+		}
+		last->sent_at_ = now;
+		metrics_->on_submitted(cnt);
+#endif
+	}
+
+	void on_dropped([[maybe_unused]] const std::uint64_t cnt) noexcept
+	{
+#if THREAD_HIGHWAYS_METRICS
+		if (metrics_)
+			metrics_->on_dropped(cnt);
+#endif
+	}
+
+	void publish_chain(Holder<T> * first, Holder<T> * last)
+	{
+		if (!first)
+			return;
+		on_sent(first, last);
+		messages_stack_.push_chain(first, last);
+		if (first == last)
+		{
+			messages_stack_event_.signal_keep_one();
+		}
+		else
+		{
+			messages_stack_event_.signal_to_all();
+		}
+	}
+
+	Holder<T> * get_free_holder_may_blocked()
 	{
 		Holder<T> * holder{nullptr};
 		do
@@ -157,21 +566,22 @@ public: // IMailBoxSendHere
 			holder = aba_safe_get_free_holder();
 			if (holder)
 				break;
-			empty_holders_stack_semaphore_.wait();
+			empty_holders_event_.wait(
+				[this]
+				{
+					return has_free_holders() || !keep_execution_.load(std::memory_order_acquire);
+				});
 		}
 		while (keep_execution_.load(std::memory_order_relaxed));
+		return holder;
+	}
 
-		if (!holder)
-		{
-			return; // keep_execution_ был сброшен
-		}
-
-		holder->t_ = std::move(t);
-		messages_stack_.push(holder);
-		messages_stack_semaphore_.signal_keep_one();
+	bool has_free_holders() const noexcept
+	{
+		return capacity_.load(std::memory_order_relaxed) > allocated_holders_.load(std::memory_order_relaxed)
+			|| empty_holders_queue_.access_stack() || empty_holders_stack_.access_stack();
 	}
 
-private:
 	Holder<T> * aba_safe_get_free_holder()
 	{
 		// Преимущество отдаётся аллокации новых холдеров чтобы получить capacity объём
@@ -180,8 +590,20 @@ private:
 		// и почтовый ящик выйдет на рабочую скорость (== есть эффект прогрева двигателя)
 		if (capacity_.load(std::memory_order_relaxed) > allocated_holders_.load(std::memory_order_relaxed))
 		{
-			++allocated_holders_;
-			return new Holder<T>{};
+			if (!slab_size_)
+			{
+				++allocated_holders_;
+				return new Holder<T>{};
+			}
+			if (Holder<T> * holder = allocate_holders())
+			{
+				// the rest of the slab is for the other senders
+				if (push_free_chain(holder->next_in_stack_))
+				{
+					empty_holders_event_.signal_to_all();
+				}
+				return holder;
+			}
 		}
 
 		// Очередь обеспечивает защиту от ABA за счёт того что анализируемый на compare_exchange_weak
@@ -189,18 +611,125 @@ private:
 		// не в empty_holders_stack_, а в конец очереди empty_holders_queue_
 		// и потом потребуется ещё один переход в messages_stack_. Этот двойной переход
 		// с промежуточной capacity_ массой делает ABA практически невозможной.
-		Holder<T> * holder = empty_holders_queue_.pop();
+		Holder<T> * holder = pinned_pop(empty_holders_queue_);
 		if (holder)
 			return holder;
 
 		empty_holders_stack_.move_to(empty_holders_queue_);
-		return empty_holders_queue_.pop();
+		return pinned_pop(empty_holders_queue_);
+	}
+
+	/**
+	 * @brief allocate_holders
+	 * New holders within the capacity: one by one or a slab
+	 * @return chain of the holders or nullptr if the capacity is reached
+	 */
+	Holder<T> * allocate_holders()
+	{
+		const std::uint32_t slab_size = slab_size_ ? slab_size_ : 1u;
+		auto allocated = allocated_holders_.load(std::memory_order_relaxed);
+		std::uint32_t cnt{0u};
+		do
+		{
+			const auto capacity = capacity_.load(std::memory_order_relaxed);
+			if (allocated >= capacity)
+				return nullptr;
+			cnt = std::min(slab_size, capacity - allocated);
+		}
+		while (!allocated_holders_.compare_exchange_weak(allocated, allocated + cnt, std::memory_order_relaxed));
+
+		if constexpr (SlabHolders<T>::value)
+		{
+			if (slab_size_)
+				return make_holders_slab<T>(cnt, huge_pages_);
+		}
+		return new Holder<T>{};
+	}
+
+	// Returning the chain of the holders to the free ones, returns false if the chain is empty
+	bool push_free_chain(Holder<T> * first) noexcept
+	{
+		if (!first)
+			return false;
+		Holder<T> * last = first;
+		while (last->next_in_stack_)
+		{
+			last = last->next_in_stack_;
+		}
+		empty_holders_stack_.push_chain(first, last);
+		return true;
+	}
+
+	// The popped holder may be deleted by the reclamation => ThreadSafeStack::pop() must be pinned
+	Holder<T> * pinned_pop(ThreadSafeStack<Holder<T>> & stack) noexcept
+	{
+		typename EpochReclamation<Holder<T>>::Guard guard{
+			reclamation_enabled_.load(std::memory_order_relaxed) ? &epochs_ : nullptr};
+		return stack.pop();
+	}
+
+	void stop_holders_reclamation()
+	{
+		if (!reclamation_ticket_)
+			return;
+		// waits for the running reclaim_holders()
+		reclamation_ticket_->cancel();
+		reclamation_ticket_.reset();
+		reclamation_enabled_.store(false, std::memory_order_seq_cst);
+		// the pops pinned before may still read the retired holders: both limbos are deleted after them
+		epochs_.synchronize();
+	}
+
+	// Reclaimer thread
+	void reclaim_holders()
+	{
+		// the holders retired on the previous check are no longer read by anyone?
+		epochs_.reclaim();
+
+		const auto allocated = allocated_holders_.load(std::memory_order_relaxed);
+		if (allocated <= low_watermark_)
+		{
+			// nothing to free: the free holders are not taken from the senders
+			previous_free_cnt_ = 0u;
+			return;
+		}
+
+		SingleThreadStack<Holder<T>> free_holders;
+		empty_holders_queue_.move_to(free_holders);
+		empty_holders_stack_.move_to(free_holders);
+		// A sender stalled in pinned_pop() may still hold a taken holder as the head of the queue:
+		// if the holder returned to the head before the sender's compare_exchange, the sender would
+		// install its stale next_in_stack_ (maybe retired now). The queue lost its ABA protection
+		// (the capacity_ pass) => the holders return only after such senders have left.
+		epochs_.synchronize();
+		std::uint32_t free_cnt{0u};
+		for (auto holder = free_holders.get_first(); holder; holder = holder->next_in_stack_)
+		{
+			++free_cnt;
+		}
+
+		// so many holders were not needed during the whole cool down
+		std::uint32_t surplus = std::min(free_cnt, previous_free_cnt_);
+		surplus = std::min(surplus, allocated - low_watermark_);
+
+		SingleThreadStack<Holder<T>> retired;
+		for (std::uint32_t i = 0; i < surplus; ++i)
+		{
+			retired.push(free_holders.pop());
+		}
+		allocated_holders_.fetch_sub(surplus, std::memory_order_relaxed);
+		empty_holders_stack_.fetch_from(free_holders);
+		empty_holders_event_.signal_to_all();
+		previous_free_cnt_ = free_cnt - surplus;
+
+		epochs_.retire(retired.swap(nullptr));
+		epochs_.reclaim();
 	}
 
 private:
 	// Filled pending holders
 	ThreadSafeStack<Holder<T>> messages_stack_;
-	Semaphore messages_stack_semaphore_;
+	Event messages_stack_event_;
 
 	// Pool of free holders
 	ThreadSafeStack<Holder<T>> empty_holders_stack_;
@@ -212,15 +741,31 @@ private:
 	// В альтернативных защитах от ABA используется счётчик-идентификатор состояния холдера - по сути инструмент
 	// аналогичный)
 	ThreadSafeStack<Holder<T>> empty_holders_queue_;
-	Semaphore empty_holders_stack_semaphore_;
+	Event empty_holders_event_;
 
 	// Holder allocation limiter
-	std::atomic<std::uint32_t> capacity_{1024};
+	std::atomic<std::uint32_t> capacity_{default_capacity_};
 	std::atomic<std::uint32_t> allocated_holders_{0};
 
 	// Unrolled stack - so the messages are now in the correct order
 	ThreadSafeStack<Holder<T>> work_queue_;
 	std::atomic<bool> keep_execution_{true};
+
+	// See set_holders_allocation
+	std::uint32_t slab_size_{0u};
+	bool huge_pages_{false};
+
+	// Returning the holders to the heap (see set_holders_reclamation)
+	std::atomic<bool> reclamation_enabled_{false};
+	std::uint32_t low_watermark_{0u};
+	// reclaimer thread only
+	std::uint32_t previous_free_cnt_{0u};
+	EpochReclamation<Holder<T>> epochs_;
+	std::shared_ptr<HoldersReclaimer::Ticket> reclamation_ticket_;
+
+#if THREAD_HIGHWAYS_METRICS
+	std::shared_ptr<Metrics> metrics_;
+#endif
 };
 
 } // namespace hi
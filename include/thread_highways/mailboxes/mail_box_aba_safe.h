@@ -8,8 +8,8 @@
 #ifndef THREADS_HIGHWAYS_MAILBOXES_MAIL_BOX_ABA_SAFE_H
 #define THREADS_HIGHWAYS_MAILBOXES_MAIL_BOX_ABA_SAFE_H
 
+#include <thread_highways/tools/event_count.h>
 #include <thread_highways/tools/exception.h>
-#include <thread_highways/tools/semaphore.h>
 #include <thread_highways/tools/stack_aba_safe.h>
 
 #include <atomic>
@@ -26,9 +26,9 @@ namespace hi
  * @brief MailBoxAbaSafe
  * Thread-safe mutexless mailbox with control over the total number of holders.
  * Holder is a container for your message to be added to the message queue.
- *
+ * Event - how the waiting threads are woken up (EventCount or Semaphore).
  */
-template <typename T>
+template <typename T, typename Event = EventCount>
 class MailBoxAbaSafe
 {
 public:
@@ -40,16 +40,21 @@ public:
 
 	void move_stack(std::stack<T> & work_queue, std::chrono::nanoseconds max_wait)
 	{
-		if (messages_stack_.empty())
-		{
-			message_semaphore_.wait_for(max_wait);
-		}
-		messages_stack_.move_to(work_queue);
+		message_event_.wait_for(
+			[this]
+			{
+				return !messages_stack_.empty();
+			},
+			max_wait);
+		move_stack_no_wait(work_queue);
 	}
 
 	void move_stack_no_wait(std::stack<T> & work_queue)
 	{
+		if (messages_stack_.empty())
+			return;
 		messages_stack_.move_to(work_queue);
+		free_holder_event_.signal_to_all();
 	}
 
 	/**
@@ -63,13 +68,19 @@ public:
 		AbaSafeHolder<T> * re = work_queue_.pop();
 		while (!re && keep_execution_.load(std::memory_order_acquire))
 		{
-			if (messages_stack_.empty())
-			{
-				message_semaphore_.wait();
-			}
+			message_event_.wait(
+				[this]
+				{
+					return !messages_stack_.empty() || !keep_execution_.load(std::memory_order_acquire);
+				});
 			move_to_work_queue();
 			re = work_queue_.pop();
 		}
+		if (re && !work_queue_.empty())
+		{
+			// there is more work for the other consumers
+			message_event_.signal();
+		}
 		return re;
 	}
 
@@ -95,19 +106,18 @@ public:
 	 * @brief free_holder
 	 * Returning a holder to the pool of released holders.
 	 * @param holder
-	 * @note for those who are waiting for the release
-	 * of holders on the semaphore gives a signal
+	 * @note wakes up the one waiting for the release of holders (if any)
 	 */
 	void free_messages_stack_holder(AbaSafeHolder<T> & holder)
 	{
 		messages_stack_.free_holder(holder);
-		free_holder_semaphore_.signal();
+		free_holder_event_.signal();
 	}
 
 	void free_work_queue_holder(AbaSafeHolder<T> & holder)
 	{
 		work_queue_.free_holder(holder);
-		free_holder_semaphore_.signal();
+		free_holder_event_.signal();
 	}
 
 	/**
@@ -117,8 +127,8 @@ public:
 	void destroy()
 	{
 		keep_execution_.store(false, std::memory_order_release);
-		message_semaphore_.destroy();
-		free_holder_semaphore_.destroy();
+		message_event_.destroy();
+		free_holder_event_.destroy();
 	}
 
 public: // IMailBoxSendHere
@@ -136,14 +146,14 @@ public: // IMailBoxSendHere
 			return false;
 		holder->t_ = std::move(t);
 		messages_stack_.push(*holder);
-		message_semaphore_.signal_keep_one();
+		message_event_.signal_keep_one();
 		return true;
 	}
 
 	/**
 	 * @brief send_may_blocked
 	 * Passing the message object to the mailbox for storage.
-	 * If the holders are over, then it will block on the semaphore
+	 * If the holders are over, then it will block on the event
 	 *  and will wait for the holders to become free.
 	 * @param t - message object
 	 */
@@ -155,7 +165,11 @@ public: // IMailBoxSendHere
 			holder = messages_stack_.allocate_holder();
 			if (holder)
 				break;
-			free_holder_semaphore_.wait(); // std::memory_order_acquire
+			free_holder_event_.wait(
+				[this]
+				{
+					return messages_stack_.has_free_holder() || !keep_execution_.load(std::memory_order_acquire);
+				});
 		}
 		while (keep_execution_.load(std::memory_order_relaxed));
 
@@ -166,7 +180,7 @@ public: // IMailBoxSendHere
 
 		holder->t_ = std::move(t);
 		messages_stack_.push(*holder);
-		message_semaphore_.signal_keep_one();
+		message_event_.signal_keep_one();
 	}
 
 	void move_to_work_queue()
@@ -179,21 +193,23 @@ public: // IMailBoxSendHere
 			if (!from_holder)
 			{
 				work_queue_.free_holder(*to_holder);
-				return;
+				break;
 			}
 			to_holder->t_ = std::move(from_holder->t_);
 			messages_stack_.free_holder(*from_holder);
 			work_queue_.push(*to_holder);
 		}
+		// the released messages_stack_ holders are awaited by the senders
+		free_holder_event_.signal_to_all();
 	}
 
 private:
 	// Filled pending holders
 	ThreadAbaSafeStack<T> messages_stack_;
 	// Сигнал про новое сообщение
-	Semaphore message_semaphore_;
+	Event message_event_;
 	// Сигнал про возможность принять новое сообщение
-	Semaphore free_holder_semaphore_;
+	Event free_holder_event_;
 
 	// Holder allocation limiter
 	std::atomic<std::uint32_t> capacity_{1024};
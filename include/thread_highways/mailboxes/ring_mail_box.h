@@ -0,0 +1,453 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_MAILBOXES_RING_MAIL_BOX_H
+#define THREADS_HIGHWAYS_MAILBOXES_RING_MAIL_BOX_H
+
+#include <thread_highways/tools/event_count.h>
+#include <thread_highways/tools/holders_reclaimer.h>
+#include <thread_highways/tools/holders_slab.h>
+#include <thread_highways/tools/metrics.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief RingMailBox
+ * Bounded multi-producer single-consumer mailbox on a contiguous ring (D. Vyukov's bounded queue):
+ *  the messages are kept inline in the cache-line-aligned slots, each slot has its own sequence number,
+ *  so the producers do one CAS on the enqueue position and the consumer does no CAS at all.
+ * The consumer executes the message in place and returns the slot with free_holder() (in the order of extraction).
+ * Same sending semantics as MailBox: send_may_fail / send_may_blocked and batches.
+ * Differences from MailBox:
+ *  - the capacity is fixed by the constructor (rounded up to a power of two), all the slots are allocated at once;
+ *  - only one consumer thread.
+ * Event - how the waiting threads are woken up (EventCount or Semaphore).
+ */
+template <typename T, typename Event = EventCount>
+class RingMailBox
+{
+public:
+	struct alignas(64) Slot
+	{
+		// == position: free for the producer of this position,
+		// == position + 1: filled for the consumer
+		std::atomic<std::uint64_t> sequence_{0u};
+		T t_;
+#if THREAD_HIGHWAYS_METRICS
+		// When the message was sent to the mailbox (for the queueing delay)
+		std::chrono::steady_clock::time_point sent_at_{};
+#endif
+	};
+
+	/**
+	 * @brief WorkQueue
+	 * Consumer side view of the filled slots (the counterpart of the unrolled stack of MailBox):
+	 *  attached by move_to(), gives the slots in the order of sending.
+	 */
+	class WorkQueue
+	{
+	public:
+		[[nodiscard]] Slot * pop()
+		{
+			return mail_box_ ? mail_box_->pop_message_no_wait() : nullptr;
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return !mail_box_ || !mail_box_->has_messages();
+		}
+
+	private:
+		friend class RingMailBox;
+		RingMailBox * mail_box_{nullptr};
+	};
+
+	static constexpr std::uint32_t default_capacity_{1024u};
+
+	explicit RingMailBox(const std::uint32_t capacity = default_capacity_)
+		: capacity_{round_up_capacity(capacity)}
+		, mask_{capacity_ - 1u}
+		, slots_{new Slot[capacity_]}
+	{
+		for (std::uint64_t i = 0; i < capacity_; ++i)
+		{
+			slots_[i].sequence_.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// The ring is already one contiguous block touched by the constructor: HoldersAllocation changes nothing
+	RingMailBox(const std::uint32_t capacity, const HoldersAllocation &)
+		: RingMailBox{capacity}
+	{
+	}
+
+	RingMailBox(const RingMailBox &) = delete;
+	RingMailBox & operator=(const RingMailBox &) = delete;
+
+	/**
+	 * @brief set_metrics
+	 * Attaching the counters: sent/dropped messages are counted by the mailbox,
+	 *  executed ones - by the consumer (see MetricsScope)
+	 * @param metrics - may be shared by several mailboxes
+	 * @note does nothing if the metrics are disabled (THREAD_HIGHWAYS_METRICS)
+	 */
+	void set_metrics([[maybe_unused]] std::shared_ptr<Metrics> metrics)
+	{
+#if THREAD_HIGHWAYS_METRICS
+		metrics_ = std::move(metrics);
+#endif
+	}
+
+	// nullptr if there are no metrics
+	[[nodiscard]] Metrics * metrics() const noexcept
+	{
+#if THREAD_HIGHWAYS_METRICS
+		return metrics_.get();
+#else
+		return nullptr;
+#endif
+	}
+
+	[[nodiscard]] std::uint32_t capacity() const noexcept
+	{
+		return static_cast<std::uint32_t>(capacity_);
+	}
+
+	// All the slots are allocated by the constructor
+	[[nodiscard]] std::uint32_t allocated_holders() const noexcept
+	{
+		return static_cast<std::uint32_t>(capacity_);
+	}
+
+	[[nodiscard]] std::uint64_t heap_usage() const noexcept
+	{
+		return capacity_ * sizeof(Slot);
+	}
+
+	// The slots are allocated (and first touched) by the constructor, nothing to reserve
+	void reserve_holders()
+	{
+	}
+
+	void move_to(WorkQueue & work_queue, std::chrono::nanoseconds max_wait)
+	{
+		messages_event_.wait_for(
+			[this]
+			{
+				return has_messages();
+			},
+			max_wait);
+		work_queue.mail_box_ = this;
+	}
+
+	/**
+	 * @brief move_to
+	 * Waiting for the messages or for the wake_condition
+	 * @param wake_condition - one more reason to stop waiting (messages in other mailboxes, for example).
+	 *  Whoever makes it true must call wake()
+	 */
+	template <typename Condition>
+	void move_to(WorkQueue & work_queue, std::chrono::nanoseconds max_wait, Condition && wake_condition)
+	{
+		messages_event_.wait_for(
+			[&]
+			{
+				return has_messages() || wake_condition();
+			},
+			max_wait);
+		work_queue.mail_box_ = this;
+	}
+
+	// Wakes up the consumer waiting in move_to() with wake_condition
+	void wake()
+	{
+		messages_event_.signal();
+	}
+
+	void move_to_no_wait(WorkQueue & work_queue)
+	{
+		work_queue.mail_box_ = this;
+	}
+
+	/**
+	 * @brief pop_message_no_wait
+	 * Extracting the next filled slot (consumer only).
+	 * The message stays in the slot until free_holder()
+	 * @return slot or nullptr
+	 */
+	[[nodiscard]] Slot * pop_message_no_wait()
+	{
+		const auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+		Slot & slot = slots_[pos & mask_];
+		if (slot.sequence_.load(std::memory_order_acquire) != pos + 1u)
+			return nullptr;
+		dequeue_pos_.store(pos + 1u, std::memory_order_relaxed);
+		return &slot;
+	}
+
+	// There are messages waiting to be extracted
+	[[nodiscard]] bool has_messages() const noexcept
+	{
+		const auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+		return slots_[pos & mask_].sequence_.load(std::memory_order_acquire) == pos + 1u;
+	}
+
+	/**
+	 * @brief free_holder
+	 * Returning the slot to the producers (the slots must be returned in the order of extraction).
+	 * @param slot
+	 * @note wakes up the one waiting for the free slots (if any)
+	 */
+	void free_holder(Slot * slot)
+	{
+		slot->t_.clear();
+		// filled for position p (== p + 1) => free for position p + capacity
+		const auto sequence = slot->sequence_.load(std::memory_order_relaxed);
+		slot->sequence_.store(sequence - 1u + capacity_, std::memory_order_release);
+		free_slots_event_.signal();
+	}
+
+	/**
+	 * @brief destroy
+	 * Preparing a mailbox for destruction
+	 */
+	void destroy()
+	{
+		keep_execution_.store(false, std::memory_order_release);
+		free_slots_event_.destroy();
+		messages_event_.destroy();
+	}
+
+public: // IMailBoxSendHere
+	/**
+	 * @brief send_may_fail
+	 * Passing the message object to the mailbox for storage.
+	 * Can ignore if the ring is full.
+	 * @param t - message object
+	 * @return true if the send was successful
+	 */
+	bool send_may_fail(T && t)
+	{
+		Slot * slot = try_reserve();
+		if (!slot)
+		{
+			on_dropped(1u);
+			return false; // may_fail
+		}
+		publish(slot, std::move(t));
+		messages_event_.signal_keep_one();
+		return true;
+	}
+
+	/**
+	 * @brief send_may_blocked
+	 * Passing the message object to the mailbox for storage.
+	 * If the ring is full, then it will block on the event
+	 *  and will wait for the consumer to free a slot.
+	 * @param t - message object
+	 */
+	void send_may_blocked(T && t)
+	{
+		Slot * slot = reserve_may_blocked();
+		if (!slot)
+		{
+			return; // keep_execution_ был сброшен
+		}
+		publish(slot, std::move(t));
+		messages_event_.signal_keep_one();
+	}
+
+	/**
+	 * @brief send_batch_may_fail
+	 * Passing a batch of message objects to the mailbox with a single reservation
+	 *  (one CAS on the enqueue position and one wake-up of the consumer).
+	 * All or nothing: if there are not enough free slots for the whole batch,
+	 *  then nothing is sent and the batch stays untouched.
+	 * @param batch - message objects (in the order of execution)
+	 * @return true if the send was successful
+	 */
+	bool send_batch_may_fail(std::vector<T> && batch)
+	{
+		if (batch.empty())
+			return true;
+		const std::uint64_t cnt = batch.size();
+		if (cnt > capacity_)
+		{
+			on_dropped(cnt);
+			return false;
+		}
+
+		auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			// the consumer frees the slots in order: the last slot of the range is free => all of them are free
+			const auto last = pos + cnt - 1u;
+			const auto diff =
+				static_cast<std::int64_t>(slots_[last & mask_].sequence_.load(std::memory_order_acquire) - last);
+			if (diff == 0)
+			{
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + cnt, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				on_dropped(cnt);
+				return false; // may_fail
+			}
+			else
+			{
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		for (auto & t : batch)
+		{
+			publish(&slots_[pos & mask_], std::move(t));
+			++pos;
+		}
+		messages_event_.signal_keep_one();
+		return true;
+	}
+
+	/**
+	 * @brief send_batch_may_blocked
+	 * Passing a batch of message objects to the mailbox with one wake-up of the consumer.
+	 * If the ring is full, then the already sent part of the batch is being executed
+	 *  and it will block on the event until the slots become free.
+	 * @param batch - message objects (in the order of execution)
+	 */
+	void send_batch_may_blocked(std::vector<T> && batch)
+	{
+		for (auto && t : batch)
+		{
+			Slot * slot = try_reserve();
+			if (!slot)
+			{
+				// the consumer must not sleep with the sent part of the batch
+				messages_event_.signal_keep_one();
+				slot = reserve_may_blocked();
+				if (!slot)
+				{
+					return; // keep_execution_ был сброшен
+				}
+			}
+			publish(slot, std::move(t));
+		}
+		messages_event_.signal_keep_one();
+	}
+
+private:
+	static std::uint64_t round_up_capacity(const std::uint32_t capacity) noexcept
+	{
+		std::uint64_t re{2u};
+		while (re < capacity)
+		{
+			re <<= 1u;
+		}
+		return re;
+	}
+
+	// The free slot of the next position or nullptr if the ring is full
+	Slot * try_reserve()
+	{
+		auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot & slot = slots_[pos & mask_];
+			const auto diff = static_cast<std::int64_t>(slot.sequence_.load(std::memory_order_acquire) - pos);
+			if (diff == 0)
+			{
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+					return &slot;
+			}
+			else if (diff < 0)
+			{
+				return nullptr; // the consumer has not freed this slot yet
+			}
+			else
+			{
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	Slot * reserve_may_blocked()
+	{
+		Slot * slot{nullptr};
+		do
+		{
+			slot = try_reserve();
+			if (slot)
+				break;
+			free_slots_event_.wait(
+				[this]
+				{
+					return has_free_slots() || !keep_execution_.load(std::memory_order_acquire);
+				});
+		}
+		while (keep_execution_.load(std::memory_order_relaxed));
+		return slot;
+	}
+
+	bool has_free_slots() const noexcept
+	{
+		const auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+		return slots_[pos & mask_].sequence_.load(std::memory_order_acquire) == pos;
+	}
+
+	void publish(Slot * slot, T && t)
+	{
+		slot->t_ = std::move(t);
+#if THREAD_HIGHWAYS_METRICS
+		if (metrics_)
+		{
+			slot->sent_at_ = std::chrono::steady_clock::now();
+			metrics_->on_submitted(1u);
+		}
+#endif
+		// reserved for position p (== p) => filled (== p + 1)
+		slot->sequence_.store(slot->sequence_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+	}
+
+	void on_dropped([[maybe_unused]] const std::uint64_t cnt) noexcept
+	{
+#if THREAD_HIGHWAYS_METRICS
+		if (metrics_)
+			metrics_->on_dropped(cnt);
+#endif
+	}
+
+private:
+	const std::uint64_t capacity_;
+	const std::uint64_t mask_;
+	const std::unique_ptr<Slot[]> slots_;
+
+	// producers
+	alignas(64) std::atomic<std::uint64_t> enqueue_pos_{0u};
+	Event free_slots_event_;
+
+	// consumer
+	alignas(64) std::atomic<std::uint64_t> dequeue_pos_{0u};
+	Event messages_event_;
+
+	std::atomic<bool> keep_execution_{true};
+
+#if THREAD_HIGHWAYS_METRICS
+	std::shared_ptr<Metrics> metrics_;
+#endif
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_MAILBOXES_RING_MAIL_BOX_H
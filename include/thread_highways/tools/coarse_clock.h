@@ -0,0 +1,17 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_COARSE_CLOCK_H
+#define THREADS_HIGHWAYS_TOOLS_COARSE_CLOCK_H
+
+#if __linux__
+#	include <thread_highways/tools/linux/coarse_clock.h>
+#else
+#	include <thread_highways/tools/default/coarse_clock.h>
+#endif
+
+#endif // THREADS_HIGHWAYS_TOOLS_COARSE_CLOCK_H
@@ -0,0 +1,47 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_COMMON_THREAD_PLACEMENT_STRUCT_H
+#define THREADS_HIGHWAYS_TOOLS_COMMON_THREAD_PLACEMENT_STRUCT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief ThreadPlacement
+ * Where and how the thread of a highway (worker) is running.
+ * Everything is best effort: what the OS does not allow (SCHED_FIFO without rights, for example) is skipped.
+ * Default values do not change anything.
+ */
+struct ThreadPlacement
+{
+	// Cores the thread may run on (empty == as allowed to the process)
+	std::vector<std::uint32_t> cores_;
+	// NUMA node: if cores_ is empty, then the thread may run on the cores of this node
+	std::optional<std::uint32_t> numa_node_;
+	// SCHED_FIFO priority (1..99), 0 == the default scheduling policy
+	std::int32_t fifo_priority_{0};
+	// Nice value for the default scheduling policy, 0 == not changed
+	std::int32_t nice_{0};
+	// Stack size in bytes, 0 == default
+	std::size_t stack_size_{0u};
+	// If several threads are started with the placement (workers, highways of the manager),
+	// then each of them is pinned to its own core of the placement cores (round robin)
+	bool spread_across_cores_{false};
+	// The highway thread allocates all the holders of its mailbox itself (on its own NUMA node),
+	// otherwise holders are allocated by the senders on demand
+	bool numa_local_holders_{false};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_COMMON_THREAD_PLACEMENT_STRUCT_H
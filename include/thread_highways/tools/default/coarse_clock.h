@@ -0,0 +1,30 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_DEFAULT_COARSE_CLOCK_H
+#define THREADS_HIGHWAYS_TOOLS_DEFAULT_COARSE_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace hi
+{
+
+/**
+ * @brief coarse_now
+ * No cheaper clock here: std::chrono::steady_clock
+ * @return nanoseconds, comparable only with other coarse_now() results
+ */
+inline std::int64_t coarse_now() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_DEFAULT_COARSE_CLOCK_H
@@ -0,0 +1,116 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_DEFAULT_EVENT_COUNT_H
+#define THREADS_HIGHWAYS_TOOLS_DEFAULT_EVENT_COUNT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace hi
+{
+
+/**
+ * @brief EventCount
+ * Waiting for a condition on std::condition_variable (std::chrono::steady_clock timeouts).
+ * Waiters are counted, so signal() does not touch the mutex if nobody is waiting.
+ */
+class EventCount
+{
+public:
+	EventCount() = default;
+	EventCount(const EventCount & other) = delete;
+	EventCount & operator=(const EventCount & other) = delete;
+
+	void destroy()
+	{
+		keep_run_.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lg(mutex_);
+		}
+		cv_.notify_all();
+	}
+
+	template <typename Condition>
+	bool wait(Condition && condition)
+	{
+		if (condition())
+			return true;
+		std::unique_lock<std::mutex> lk(mutex_);
+		waiters_.fetch_add(1u, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		cv_.wait(
+			lk,
+			[&]
+			{
+				return condition() || !keep_run_.load(std::memory_order_acquire);
+			});
+		waiters_.fetch_sub(1u, std::memory_order_release);
+		return condition();
+	}
+
+	template <typename Condition>
+	bool wait_for(Condition && condition, std::chrono::nanoseconds max_wait)
+	{
+		if (condition() || max_wait <= std::chrono::nanoseconds{})
+			return condition();
+		std::unique_lock<std::mutex> lk(mutex_);
+		waiters_.fetch_add(1u, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const bool re = cv_.wait_for(
+			lk,
+			max_wait,
+			[&]
+			{
+				return condition() || !keep_run_.load(std::memory_order_acquire);
+			});
+		waiters_.fetch_sub(1u, std::memory_order_release);
+		return re && condition();
+	}
+
+	void signal()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiters_.load(std::memory_order_relaxed))
+		{
+			{
+				std::lock_guard<std::mutex> lg(mutex_);
+			}
+			cv_.notify_one();
+		}
+	}
+
+	void signal_keep_one()
+	{
+		signal();
+	}
+
+	void signal_to_all()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiters_.load(std::memory_order_relaxed))
+		{
+			{
+				std::lock_guard<std::mutex> lg(mutex_);
+			}
+			cv_.notify_all();
+		}
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::atomic<std::uint32_t> waiters_{0u};
+	std::atomic_bool keep_run_{true};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_DEFAULT_EVENT_COUNT_H
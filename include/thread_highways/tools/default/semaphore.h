@@ -56,6 +56,27 @@ public:
 		return false;
 	}
 
+	// Condition based interface (same as EventCount) so the Semaphore can be used as a MailBox event
+	template <typename Condition>
+	bool wait(Condition && condition)
+	{
+		if (!condition())
+		{
+			wait();
+		}
+		return condition();
+	}
+
+	template <typename Condition>
+	bool wait_for(Condition && condition, std::chrono::nanoseconds ns)
+	{
+		if (!condition())
+		{
+			wait_for(ns);
+		}
+		return condition();
+	}
+
 	// Если нужен true|false семафор - то не постим если уже запостили
 	void signal_keep_one()
 	{
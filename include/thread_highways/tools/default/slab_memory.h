@@ -0,0 +1,39 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_DEFAULT_SLAB_MEMORY_H
+#define THREADS_HIGHWAYS_TOOLS_DEFAULT_SLAB_MEMORY_H
+
+#include <cstddef>
+#include <new>
+
+namespace hi
+{
+
+// Huge pages are not supported on this platform: cache line aligned heap memory
+
+[[maybe_unused]] inline constexpr std::size_t slab_memory_size(const std::size_t bytes, const bool /* huge_pages */) noexcept
+{
+	return bytes;
+}
+
+[[maybe_unused]] inline void * allocate_slab_memory(std::size_t & bytes, const bool /* huge_pages */)
+{
+	return ::operator new(bytes, std::align_val_t{64u});
+}
+
+[[maybe_unused]] inline void free_slab_memory(
+	void * memory,
+	const std::size_t /* bytes */,
+	const bool /* huge_pages */) noexcept
+{
+	::operator delete(memory, std::align_val_t{64u});
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_DEFAULT_SLAB_MEMORY_H
@@ -0,0 +1,44 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_DEFAULT_THREAD_PLACEMENT_H
+#define THREADS_HIGHWAYS_TOOLS_DEFAULT_THREAD_PLACEMENT_H
+
+#include <thread_highways/tools/common/thread_placement_struct.h>
+#include <thread_highways/tools/raii_thread.h>
+
+#include <functional>
+#include <thread>
+
+namespace hi
+{
+
+// Placement is not supported on this platform: the threads run as the OS decides
+
+[[maybe_unused]] inline std::vector<std::uint32_t> placement_cores(const ThreadPlacement & placement)
+{
+	return placement.cores_;
+}
+
+[[maybe_unused]] inline bool apply_this_thread_placement(const ThreadPlacement & placement)
+{
+	return placement.cores_.empty() && !placement.numa_node_ && !placement.fifo_priority_ && !placement.nice_;
+}
+
+[[maybe_unused]] inline RAIIthread start_thread(const ThreadPlacement & placement, std::function<void()> fun)
+{
+	return RAIIthread(std::thread(
+		[placement, fun = std::move(fun)]
+		{
+			apply_this_thread_placement(placement);
+			fun();
+		}));
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_DEFAULT_THREAD_PLACEMENT_H
@@ -0,0 +1,169 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_EPOCH_RECLAMATION_H
+#define THREADS_HIGHWAYS_TOOLS_EPOCH_RECLAMATION_H
+
+#include <thread_highways/tools/stack.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace hi
+{
+
+/**
+ * @brief EpochReclamation
+ * Epoch-based reclamation of the holders of the lock-free stacks:
+ *  a thread that may dereference a holder popped by another thread (ThreadSafeStack::pop())
+ *  pins the current epoch for the duration of the pop;
+ *  a retired holder is deleted only after the epoch has advanced twice,
+ *  and the epoch advances only when no thread is pinned in the previous one
+ *  => nobody can still read the deleted holder.
+ * Pinning costs two RMW on the counter of the epoch parity: MailBox pins only while its reclamation is on.
+ * @note retire() and reclaim() are called by one thread at a time
+ */
+template <typename Holder>
+class EpochReclamation
+{
+public:
+	EpochReclamation() = default;
+	EpochReclamation(const EpochReclamation &) = delete;
+	EpochReclamation & operator=(const EpochReclamation &) = delete;
+
+	/**
+	 * @brief Guard
+	 * Pins the current epoch (does nothing if reclamation is nullptr)
+	 */
+	class Guard
+	{
+	public:
+		explicit Guard(EpochReclamation * reclamation) noexcept
+			: reclamation_{reclamation}
+			, parity_{reclamation ? reclamation->enter() : 0u}
+		{
+		}
+
+		~Guard()
+		{
+			if (reclamation_)
+			{
+				reclamation_->active_[parity_].fetch_sub(1u, std::memory_order_release);
+			}
+		}
+
+		Guard(const Guard &) = delete;
+		Guard & operator=(const Guard &) = delete;
+
+	private:
+		EpochReclamation * const reclamation_;
+		const std::uint32_t parity_;
+	};
+
+	/**
+	 * @brief retire
+	 * The holders are no longer reachable from the stacks, delete them when it is safe
+	 * @param first - chain linked by next_in_stack_
+	 */
+	void retire(Holder * first) noexcept
+	{
+		auto & limbo = limbo_[epoch_.load(std::memory_order_relaxed) & 1u];
+		while (first)
+		{
+			Holder * next = first->next_in_stack_;
+			limbo.push(first);
+			retired_cnt_.fetch_add(1u, std::memory_order_relaxed);
+			first = next;
+		}
+	}
+
+	/**
+	 * @brief reclaim
+	 * Advancing the epoch if the threads pinned in the previous epoch have left,
+	 *  the holders retired two epochs ago are deleted
+	 */
+	void reclaim()
+	{
+		const auto epoch = epoch_.load(std::memory_order_relaxed);
+		// the previous epoch has the same parity as the next one
+		const auto previous_parity = (epoch + 1u) & 1u;
+		if (active_[previous_parity].load(std::memory_order_seq_cst))
+			return;
+
+		auto & limbo = limbo_[previous_parity];
+		while (auto holder = limbo.pop())
+		{
+			delete holder;
+			retired_cnt_.fetch_sub(1u, std::memory_order_relaxed);
+		}
+		epoch_.store(epoch + 1u, std::memory_order_seq_cst);
+	}
+
+	/**
+	 * @brief synchronize
+	 * Waiting (advancing the epoch) until the threads pinned before the call have left:
+	 *  after it nobody reads a holder that was unreachable at the call
+	 * @note a pin lasts one pop, so the wait is short; if a pinned thread is preempted,
+	 *  the caller backs off to sleeping instead of spinning
+	 */
+	void synchronize()
+	{
+		const auto target = epoch_.load(std::memory_order_relaxed) + 2u;
+		std::chrono::microseconds pause{50};
+		for (std::uint32_t attempt = 0;; ++attempt)
+		{
+			reclaim();
+			if (epoch_.load(std::memory_order_relaxed) >= target)
+				return;
+			if (attempt < yield_limit_)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			std::this_thread::sleep_for(pause);
+			pause = std::min(pause * 2, std::chrono::microseconds{1000});
+		}
+	}
+
+	// Retired, but not yet deleted
+	[[nodiscard]] std::uint32_t retired_cnt() const noexcept
+	{
+		return retired_cnt_.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::uint32_t enter() noexcept
+	{
+		for (;;)
+		{
+			const auto epoch = epoch_.load(std::memory_order_seq_cst);
+			const std::uint32_t parity = epoch & 1u;
+			active_[parity].fetch_add(1u, std::memory_order_seq_cst);
+			// the reclaimer may not have seen us before advancing
+			if (epoch_.load(std::memory_order_seq_cst) == epoch)
+				return parity;
+			active_[parity].fetch_sub(1u, std::memory_order_release);
+		}
+	}
+
+private:
+	static constexpr std::uint32_t yield_limit_{8u};
+
+	alignas(64) std::atomic<std::uint64_t> epoch_{0u};
+	alignas(64) std::array<std::atomic<std::uint32_t>, 2> active_{};
+	std::atomic<std::uint32_t> retired_cnt_{0u};
+	// reclaimer thread only
+	std::array<SingleThreadStack<Holder>, 2> limbo_;
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_EPOCH_RECLAMATION_H
@@ -0,0 +1,17 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_EVENT_COUNT_H
+#define THREADS_HIGHWAYS_TOOLS_EVENT_COUNT_H
+
+#if __linux__
+#	include <thread_highways/tools/linux/event_count.h>
+#else
+#	include <thread_highways/tools/default/event_count.h>
+#endif
+
+#endif // THREADS_HIGHWAYS_TOOLS_EVENT_COUNT_H
@@ -0,0 +1,195 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_HOLDERS_RECLAIMER_H
+#define THREADS_HIGHWAYS_TOOLS_HOLDERS_RECLAIMER_H
+
+#include <thread_highways/tools/raii_thread.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief HoldersReclamation
+ * When the holders left after a burst are returned to the heap
+ */
+struct HoldersReclamation
+{
+	// So many holders are never freed
+	std::uint32_t low_watermark_{1024u};
+	// The surplus is freed if it stayed unused for this long; zero == never free (the holders only grow)
+	std::chrono::milliseconds cool_down_{};
+};
+
+/**
+ * @brief HoldersReclaimer
+ * Shared thread that periodically calls the reclamation of the registered mailboxes
+ * (the mailbox itself has no thread of its own and must not slow down the senders with the clock).
+ */
+class HoldersReclaimer
+{
+public:
+	/**
+	 * @brief Ticket
+	 * Registration of a mailbox: the tick is not called anymore after cancel()
+	 */
+	class Ticket
+	{
+	public:
+		explicit Ticket(std::function<void()> tick)
+			: tick_{std::move(tick)}
+		{
+		}
+
+		// Waits for the running tick (if any)
+		void cancel()
+		{
+			std::lock_guard lg{mutex_};
+			tick_ = nullptr;
+		}
+
+	private:
+		friend class HoldersReclaimer;
+
+		void tick()
+		{
+			std::lock_guard lg{mutex_};
+			if (tick_)
+			{
+				tick_();
+			}
+		}
+
+		std::mutex mutex_;
+		std::function<void()> tick_;
+	};
+
+	HoldersReclaimer() = default;
+	HoldersReclaimer(const HoldersReclaimer &) = delete;
+	HoldersReclaimer & operator=(const HoldersReclaimer &) = delete;
+
+	~HoldersReclaimer()
+	{
+		destroy();
+	}
+
+	// One reclaimer thread per process (started with the first registration)
+	static HoldersReclaimer & instance()
+	{
+		static HoldersReclaimer reclaimer;
+		return reclaimer;
+	}
+
+	/**
+	 * @brief add
+	 * @param period - how often to call the tick
+	 * @param tick - reclamation of the mailbox
+	 * @return ticket, the tick is called while the ticket is alive and not cancelled
+	 */
+	std::shared_ptr<Ticket> add(const std::chrono::milliseconds period, std::function<void()> tick)
+	{
+		auto re = std::make_shared<Ticket>(std::move(tick));
+		std::lock_guard lg{mutex_};
+		if (!keep_execution_)
+			return re;
+		registered_.emplace_back(
+			Registered{re, std::max(period, std::chrono::milliseconds{1}), std::chrono::steady_clock::now() + period});
+		if (!thread_started_)
+		{
+			thread_started_ = true;
+			thread_ = RAIIthread(std::thread(
+				[this]
+				{
+					reclaimer_loop();
+				}));
+		}
+		cv_.notify_one();
+		return re;
+	}
+
+	void destroy()
+	{
+		{
+			std::lock_guard lg{mutex_};
+			keep_execution_ = false;
+		}
+		cv_.notify_one();
+		thread_.join();
+	}
+
+private:
+	struct Registered
+	{
+		std::weak_ptr<Ticket> ticket_;
+		std::chrono::milliseconds period_;
+		std::chrono::steady_clock::time_point next_tick_;
+	};
+
+	void reclaimer_loop()
+	{
+		std::unique_lock lk{mutex_};
+		while (keep_execution_)
+		{
+			auto next_tick = std::chrono::steady_clock::now() + std::chrono::hours{1};
+			for (const auto & it : registered_)
+			{
+				next_tick = std::min(next_tick, it.next_tick_);
+			}
+			cv_.wait_until(lk, next_tick);
+			if (!keep_execution_)
+				break;
+
+			const auto now = std::chrono::steady_clock::now();
+			std::vector<std::shared_ptr<Ticket>> due;
+			for (auto it = registered_.begin(); it != registered_.end();)
+			{
+				auto ticket = it->ticket_.lock();
+				if (!ticket)
+				{
+					it = registered_.erase(it);
+					continue;
+				}
+				if (now >= it->next_tick_)
+				{
+					it->next_tick_ = now + it->period_;
+					due.emplace_back(std::move(ticket));
+				}
+				++it;
+			}
+
+			// the reclamation may take a while: without the lock
+			lk.unlock();
+			for (auto & ticket : due)
+			{
+				ticket->tick();
+			}
+			due.clear();
+			lk.lock();
+		}
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<Registered> registered_;
+	bool keep_execution_{true};
+	bool thread_started_{false};
+	RAIIthread thread_;
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_HOLDERS_RECLAIMER_H
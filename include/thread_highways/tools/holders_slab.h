@@ -0,0 +1,117 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_HOLDERS_SLAB_H
+#define THREADS_HIGHWAYS_TOOLS_HOLDERS_SLAB_H
+
+#include <thread_highways/tools/slab_memory.h>
+#include <thread_highways/tools/stack.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace hi
+{
+
+/**
+ * @brief HoldersAllocation
+ * How the mailbox allocates its holders.
+ * Default values: one `new` per holder on demand (the holders are scattered over the heap).
+ */
+struct HoldersAllocation
+{
+	// Holders are allocated by contiguous slabs of so many holders, each holder starts a cache line
+	// (0 or 1 == one by one). Only for the messages with SlabHolders<T> (the tasks of the highways)
+	std::uint32_t slab_size_{0u};
+	// Slabs are placed on the transparent huge pages (Linux, best effort)
+	bool huge_pages_{false};
+	// All the holders up to the capacity are allocated (and their memory is touched) at construction
+	bool prefault_{false};
+};
+
+/**
+ * @brief holder_footprint
+ * @param in_slab - the holder is allocated in a slab
+ * @return bytes taken by one holder
+ */
+template <typename T>
+constexpr std::size_t holder_footprint(const bool in_slab) noexcept
+{
+	constexpr std::size_t cache_line{64u};
+	constexpr std::size_t bytes = sizeof(Holder<T>) + Holder<T>::prefix_size();
+	return in_slab ? (bytes + cache_line - 1u) / cache_line * cache_line : bytes;
+}
+
+/**
+ * @brief slabs_footprint
+ * @param holders - allocated slab by slab (the last slab is cut)
+ * @return bytes taken by the slabs (with the headers and the rounding up to the huge pages)
+ */
+template <typename T>
+constexpr std::uint64_t slabs_footprint(const std::uint64_t holders, const std::uint32_t slab_size, const bool huge_pages) noexcept
+{
+	constexpr std::size_t cache_line{64u};
+	const auto slab_bytes = [&](const std::uint64_t cnt) -> std::uint64_t
+	{
+		return cnt ? slab_memory_size(cache_line + holder_footprint<T>(true) * cnt, huge_pages) : 0u;
+	};
+	return holders / slab_size * slab_bytes(slab_size) + slab_bytes(holders % slab_size);
+}
+
+/**
+ * @brief make_holders_slab
+ * Allocating a slab of holders: [HoldersSlab][prefix|holder 0][prefix|holder 1]...
+ * Every holder starts a cache line (the prefix with the slab pointer is at the end of the previous line),
+ *  the whole slab is written here => the memory is faulted in by the calling thread.
+ * The holders are deleted as usual, the slab is freed with the last of them.
+ * @param cnt - how many holders
+ * @param huge_pages - advise the huge pages for the slab
+ * @return chain of the holders linked by next_in_stack_ (in the order of their addresses)
+ */
+template <typename T>
+Holder<T> * make_holders_slab(const std::uint32_t cnt, const bool huge_pages)
+{
+	constexpr std::size_t cache_line{64u};
+	static_assert(SlabHolders<T>::value, "the holders of T are not prefixed with the slab (see SlabHolders)");
+	static_assert(alignof(Holder<T>) <= cache_line, "over-aligned holders are allocated one by one");
+	static_assert(sizeof(HoldersSlab) + sizeof(HoldersSlab *) <= cache_line);
+	if (!cnt)
+		return nullptr;
+
+	constexpr std::size_t stride = holder_footprint<T>(true);
+	std::size_t bytes = cache_line + stride * cnt;
+	char * memory = static_cast<char *>(allocate_slab_memory(bytes, huge_pages));
+
+	auto slab = ::new (memory) HoldersSlab{};
+	slab->alive_.store(cnt, std::memory_order_relaxed);
+	slab->bytes_ = bytes;
+	slab->huge_pages_ = huge_pages;
+	slab->free_ = [](HoldersSlab * slab) noexcept
+	{
+		const auto bytes = slab->bytes_;
+		const auto huge_pages = slab->huge_pages_;
+		slab->~HoldersSlab();
+		free_slab_memory(slab, bytes, huge_pages);
+	};
+
+	Holder<T> * first{nullptr};
+	// from the end so that the chain goes in the order of the addresses
+	for (std::uint32_t i = cnt; i > 0u; --i)
+	{
+		char * place = memory + cache_line + stride * (i - 1u);
+		Holder<T>::slab_of(place) = slab;
+		auto holder = ::new (place) Holder<T>{};
+		holder->next_in_stack_ = first;
+		first = holder;
+	}
+	return first;
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_HOLDERS_SLAB_H
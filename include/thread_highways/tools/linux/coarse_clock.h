@@ -0,0 +1,32 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_LINUX_COARSE_CLOCK_H
+#define THREADS_HIGHWAYS_TOOLS_LINUX_COARSE_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+
+namespace hi
+{
+
+/**
+ * @brief coarse_now
+ * CLOCK_MONOTONIC_COARSE: the time of the last timer tick (a few ms resolution),
+ *  read from vDSO without the hardware counter - cheap enough for a stamp per task.
+ * @return nanoseconds, comparable only with other coarse_now() results
+ */
+inline std::int64_t coarse_now() noexcept
+{
+	timespec ts{};
+	::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+	return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_LINUX_COARSE_CLOCK_H
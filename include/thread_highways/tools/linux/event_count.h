@@ -0,0 +1,141 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_LINUX_EVENT_COUNT_H
+#define THREADS_HIGHWAYS_TOOLS_LINUX_EVENT_COUNT_H
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hi
+{
+
+/**
+ * @brief EventCount
+ * Futex based waiting for a condition.
+ * Waiters are counted, so signal() does not make a syscall if nobody is waiting.
+ * Timeouts are relative and measured by CLOCK_MONOTONIC (not affected by wall clock jumps).
+ * Protocol:
+ *  waiter: waiters_++, remember epoch_, check condition, sleep while epoch_ is the same;
+ *  signaler: change condition, if (waiters_) {epoch_++, wake}.
+ */
+class EventCount
+{
+public:
+	EventCount() = default;
+	EventCount(const EventCount & other) = delete;
+	EventCount & operator=(const EventCount & other) = delete;
+
+	void destroy()
+	{
+		keep_run_.store(false, std::memory_order_release);
+		epoch_.fetch_add(1u, std::memory_order_seq_cst);
+		futex_wake(INT_MAX);
+	}
+
+	/**
+	 * @brief wait
+	 * Waiting without timeout until condition() == true or destroy()
+	 * @param condition - what we are waiting for
+	 * @return condition() result
+	 */
+	template <typename Condition>
+	bool wait(Condition && condition)
+	{
+		return wait_impl(condition, nullptr);
+	}
+
+	/**
+	 * @brief wait_for
+	 * Waiting until condition() == true or timeout or destroy()
+	 * @param condition - what we are waiting for
+	 * @param max_wait - timeout
+	 * @return condition() result
+	 */
+	template <typename Condition>
+	bool wait_for(Condition && condition, std::chrono::nanoseconds max_wait)
+	{
+		if (max_wait <= std::chrono::nanoseconds{})
+		{
+			return condition();
+		}
+		timespec timeout;
+		timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(max_wait.count() / 1000000000);
+		timeout.tv_nsec = static_cast<decltype(timeout.tv_nsec)>(max_wait.count() % 1000000000);
+		return wait_impl(condition, &timeout);
+	}
+
+	// Wakes up one waiter (if any)
+	void signal()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst); // condition change must be visible before waiters_ check
+		if (waiters_.load(std::memory_order_relaxed))
+		{
+			epoch_.fetch_add(1u, std::memory_order_release);
+			futex_wake(1);
+		}
+	}
+
+	// Same as signal(): the condition is checked by the waiter, there are no accumulated signals
+	void signal_keep_one()
+	{
+		signal();
+	}
+
+	void signal_to_all()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiters_.load(std::memory_order_relaxed))
+		{
+			epoch_.fetch_add(1u, std::memory_order_release);
+			futex_wake(INT_MAX);
+		}
+	}
+
+private:
+	template <typename Condition>
+	bool wait_impl(Condition & condition, const timespec * timeout)
+	{
+		if (condition())
+			return true;
+
+		waiters_.fetch_add(1u, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst); // waiters_ must be visible before condition check
+		const std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+		bool re = condition();
+		if (!re && keep_run_.load(std::memory_order_acquire))
+		{
+			// returns immediately if epoch_ != epoch (signal was between the check and the sleep)
+			syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, timeout, nullptr, 0);
+			re = condition();
+		}
+		waiters_.fetch_sub(1u, std::memory_order_release);
+		return re;
+	}
+
+	void futex_wake(int count)
+	{
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+	}
+
+private:
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex needs 32 bit word");
+	std::atomic<std::uint32_t> epoch_{0u};
+	std::atomic<std::uint32_t> waiters_{0u};
+	std::atomic_bool keep_run_{true};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_LINUX_EVENT_COUNT_H
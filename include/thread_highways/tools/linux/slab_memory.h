@@ -0,0 +1,65 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_LINUX_SLAB_MEMORY_H
+#define THREADS_HIGHWAYS_TOOLS_LINUX_SLAB_MEMORY_H
+
+#include <cstddef>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace hi
+{
+
+inline constexpr std::size_t huge_page_size{2u * 1024u * 1024u};
+
+/**
+ * @brief slab_memory_size
+ * @return bytes really taken by a slab of the given size
+ */
+[[maybe_unused]] inline constexpr std::size_t slab_memory_size(const std::size_t bytes, const bool huge_pages) noexcept
+{
+	return huge_pages ? (bytes + huge_page_size - 1u) / huge_page_size * huge_page_size : bytes;
+}
+
+/**
+ * @brief allocate_slab_memory
+ * Cache line aligned heap memory or, for the huge pages, anonymous mapping
+ *  rounded up to 2MB and advised to be backed by the transparent huge pages
+ *  (best effort: if THP is disabled, then it stays on the usual pages)
+ * @param bytes - size of the slab, becomes slab_memory_size()
+ * @param huge_pages - place the slab on the huge pages
+ * @return memory, throws std::bad_alloc on failure
+ */
+[[maybe_unused]] inline void * allocate_slab_memory(std::size_t & bytes, const bool huge_pages)
+{
+	bytes = slab_memory_size(bytes, huge_pages);
+	if (!huge_pages)
+		return ::operator new(bytes, std::align_val_t{64u});
+	void * re = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (re == MAP_FAILED)
+		throw std::bad_alloc{};
+#ifdef MADV_HUGEPAGE
+	madvise(re, bytes, MADV_HUGEPAGE);
+#endif
+	return re;
+}
+
+[[maybe_unused]] inline void free_slab_memory(void * memory, const std::size_t bytes, const bool huge_pages) noexcept
+{
+	if (!huge_pages)
+	{
+		::operator delete(memory, std::align_val_t{64u});
+		return;
+	}
+	munmap(memory, bytes);
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_LINUX_SLAB_MEMORY_H
@@ -0,0 +1,191 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_LINUX_THREAD_PLACEMENT_H
+#define THREADS_HIGHWAYS_TOOLS_LINUX_THREAD_PLACEMENT_H
+
+#include <thread_highways/tools/common/thread_placement_struct.h>
+#include <thread_highways/tools/raii_thread.h>
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hi
+{
+
+/**
+ * @brief numa_node_cores
+ * @param node - NUMA node
+ * @return cores of the node (from /sys/devices/system/node/nodeN/cpulist, format "0-3,8,10-11")
+ */
+[[maybe_unused]] inline std::vector<std::uint32_t> numa_node_cores(const std::uint32_t node)
+{
+	std::vector<std::uint32_t> re;
+	std::ifstream file{std::string{"/sys/devices/system/node/node"}.append(std::to_string(node)).append("/cpulist")};
+	std::string range;
+	while (std::getline(file, range, ','))
+	{
+		std::istringstream range_stream{range};
+		std::uint32_t first{0};
+		std::uint32_t last{0};
+		if (!(range_stream >> first))
+			continue;
+		last = first;
+		if (range_stream.peek() == '-')
+		{
+			range_stream.get();
+			range_stream >> last;
+		}
+		for (auto core = first; core <= last; ++core)
+		{
+			re.push_back(core);
+		}
+	}
+	return re;
+}
+
+// Cores the process may run on
+[[maybe_unused]] inline std::vector<std::uint32_t> allowed_cores()
+{
+	std::vector<std::uint32_t> re;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) != 0)
+		return re;
+	for (std::uint32_t core = 0; core < CPU_SETSIZE; ++core)
+	{
+		if (CPU_ISSET(core, &set))
+		{
+			re.push_back(core);
+		}
+	}
+	return re;
+}
+
+/**
+ * @brief placement_cores
+ * @param placement
+ * @return cores of the placement: cores_, or cores of the numa_node_, or allowed to the process
+ */
+[[maybe_unused]] inline std::vector<std::uint32_t> placement_cores(const ThreadPlacement & placement)
+{
+	if (!placement.cores_.empty())
+		return placement.cores_;
+	if (placement.numa_node_)
+	{
+		auto re = numa_node_cores(*placement.numa_node_);
+		if (!re.empty())
+			return re;
+	}
+	return allowed_cores();
+}
+
+/**
+ * @brief apply_this_thread_placement
+ * Applies the placement to the calling thread (stack size can't be changed here)
+ * @param placement
+ * @return false if something was not allowed by the OS
+ */
+[[maybe_unused]] inline bool apply_this_thread_placement(const ThreadPlacement & placement)
+{
+	bool re{true};
+	if (!placement.cores_.empty() || placement.numa_node_)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (auto core : placement_cores(placement))
+		{
+			if (core < CPU_SETSIZE)
+			{
+				CPU_SET(core, &set);
+			}
+		}
+		re = (CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) && re;
+	}
+
+	if (placement.fifo_priority_ > 0)
+	{
+		sched_param param{};
+		param.sched_priority = std::clamp(
+			placement.fifo_priority_,
+			sched_get_priority_min(SCHED_FIFO),
+			sched_get_priority_max(SCHED_FIFO));
+		re = (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) && re;
+	}
+	else if (placement.nice_ != 0)
+	{
+		// on Linux nice is a per thread attribute
+		const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+		re = (setpriority(PRIO_PROCESS, tid, placement.nice_) == 0) && re;
+	}
+	return re;
+}
+
+/**
+ * @brief start_thread
+ * Starts the thread with the placement
+ * @param placement
+ * @param fun - thread body
+ * @return thread
+ */
+[[maybe_unused]] inline RAIIthread start_thread(const ThreadPlacement & placement, std::function<void()> fun)
+{
+	auto body = std::make_unique<std::function<void()>>(
+		[placement, fun = std::move(fun)]
+		{
+			apply_this_thread_placement(placement);
+			fun();
+		});
+	if (!placement.stack_size_)
+	{
+		return RAIIthread(std::thread(std::move(*body)));
+	}
+
+	// std::thread can't set the stack size
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, std::max<std::size_t>(placement.stack_size_, PTHREAD_STACK_MIN));
+	pthread_t thread;
+	const auto code = pthread_create(
+		&thread,
+		&attr,
+		[](void * arg) -> void *
+		{
+			std::unique_ptr<std::function<void()>> body{static_cast<std::function<void()> *>(arg)};
+			(*body)();
+			return nullptr;
+		},
+		body.get());
+	pthread_attr_destroy(&attr);
+	if (code != 0)
+	{
+		return RAIIthread(std::thread(std::move(*body)));
+	}
+	body.release(); // owned by the thread
+
+	return RAIIthread(
+		[thread]
+		{
+			pthread_join(thread, nullptr);
+		});
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_LINUX_THREAD_PLACEMENT_H
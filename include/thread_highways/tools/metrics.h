@@ -0,0 +1,225 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_METRICS_H
+#define THREADS_HIGHWAYS_TOOLS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Per-highway counters and histograms.
+// Disabled by default: build with THREAD_HIGHWAYS_METRICS=1 (cmake -DTHREAD_HIGHWAYS_METRICS=ON) to collect them.
+// When disabled nothing is measured and the mailboxes/holders have no extra fields.
+#ifndef THREAD_HIGHWAYS_METRICS
+#	define THREAD_HIGHWAYS_METRICS 0
+#endif
+
+namespace hi
+{
+
+/**
+ * @brief LogHistogram
+ * Snapshot of the log-bucket histogram of durations:
+ * buckets_[0] - 0ns, buckets_[i] - [2^(i-1), 2^i) ns, the last bucket - everything longer
+ */
+struct LogHistogram
+{
+	static constexpr std::size_t buckets_cnt{40u}; // the last bucket starts at ~4.6 minutes
+
+	static std::size_t bucket(const std::uint64_t nanoseconds) noexcept
+	{
+		if (!nanoseconds)
+			return 0u;
+#if defined(__GNUC__) || defined(__clang__)
+		const std::size_t re = 64u - static_cast<std::size_t>(__builtin_clzll(nanoseconds));
+#else
+		std::size_t re{0u};
+		for (auto value = nanoseconds; value; value >>= 1u)
+		{
+			++re;
+		}
+#endif
+		return re < buckets_cnt ? re : buckets_cnt - 1u;
+	}
+
+	// Exclusive upper bound of the bucket
+	static std::chrono::nanoseconds bucket_upper_bound(const std::size_t bucket) noexcept
+	{
+		return std::chrono::nanoseconds{std::int64_t{1} << bucket};
+	}
+
+	[[nodiscard]] std::uint64_t count() const noexcept
+	{
+		std::uint64_t re{0u};
+		for (auto cnt : buckets_)
+		{
+			re += cnt;
+		}
+		return re;
+	}
+
+	/**
+	 * @brief percentile
+	 * @param p - 0.0 .. 1.0
+	 * @return upper bound of the bucket where the percentile is (precision is x2)
+	 */
+	[[nodiscard]] std::chrono::nanoseconds percentile(const double p) const noexcept
+	{
+		const auto total = count();
+		if (!total)
+			return {};
+		const auto rank = static_cast<std::uint64_t>(p * static_cast<double>(total - 1u)) + 1u;
+		std::uint64_t cnt{0u};
+		for (std::size_t i = 0; i < buckets_cnt; ++i)
+		{
+			cnt += buckets_[i];
+			if (cnt >= rank)
+				return bucket_upper_bound(i);
+		}
+		return bucket_upper_bound(buckets_cnt - 1u);
+	}
+
+	std::array<std::uint64_t, buckets_cnt> buckets_{};
+};
+
+/**
+ * @brief MetricsSnapshot
+ * Values of the metrics at the moment of reading
+ * (each counter is read atomically, but not all together)
+ */
+struct MetricsSnapshot
+{
+	// Successfully sent to the mailboxes
+	std::uint64_t submitted_{0u};
+	// Taken from the mailboxes and executed
+	std::uint64_t executed_{0u};
+	// try_execute failed because of the lack of holders
+	std::uint64_t dropped_{0u};
+	// submitted_ - executed_
+	std::uint64_t queue_depth_{0u};
+	// Holders allocated by the mailboxes / how much they are allowed to allocate
+	std::uint64_t holders_allocated_{0u};
+	std::uint64_t holders_capacity_{0u};
+	// Bytes taken by the holders of the mailboxes
+	std::uint64_t heap_usage_{0u};
+	// From sending to the start of execution
+	LogHistogram queueing_delay_;
+	// Task execution time
+	LogHistogram execution_time_;
+};
+
+/**
+ * @brief Metrics
+ * Lock-free counters: written by the senders and the executors, read by anyone.
+ * Attached to the mailboxes with MailBox::set_metrics().
+ */
+class Metrics
+{
+public:
+	void on_submitted(const std::uint64_t cnt = 1u) noexcept
+	{
+		submitted_.fetch_add(cnt, std::memory_order_relaxed);
+	}
+
+	void on_dropped(const std::uint64_t cnt = 1u) noexcept
+	{
+		dropped_.fetch_add(cnt, std::memory_order_relaxed);
+	}
+
+	void on_executed(const std::chrono::nanoseconds queueing_delay, const std::chrono::nanoseconds execution_time) noexcept
+	{
+		executed_.fetch_add(1u, std::memory_order_relaxed);
+		add(queueing_delay_, queueing_delay);
+		add(execution_time_, execution_time);
+	}
+
+	/**
+	 * @brief snapshot
+	 * @return counters and histograms (holders_* are filled by the owner of the mailboxes)
+	 */
+	[[nodiscard]] MetricsSnapshot snapshot() const noexcept
+	{
+		MetricsSnapshot re;
+		// executed_ first: so the queue depth is not negative
+		re.executed_ = executed_.load(std::memory_order_relaxed);
+		re.submitted_ = submitted_.load(std::memory_order_relaxed);
+		re.dropped_ = dropped_.load(std::memory_order_relaxed);
+		re.queue_depth_ = re.submitted_ > re.executed_ ? re.submitted_ - re.executed_ : 0u;
+		for (std::size_t i = 0; i < LogHistogram::buckets_cnt; ++i)
+		{
+			re.queueing_delay_.buckets_[i] = queueing_delay_[i].load(std::memory_order_relaxed);
+			re.execution_time_.buckets_[i] = execution_time_[i].load(std::memory_order_relaxed);
+		}
+		return re;
+	}
+
+private:
+	using Buckets = std::array<std::atomic<std::uint64_t>, LogHistogram::buckets_cnt>;
+
+	static void add(Buckets & buckets, const std::chrono::nanoseconds duration) noexcept
+	{
+		const auto ns = duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0u;
+		buckets[LogHistogram::bucket(ns)].fetch_add(1u, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<std::uint64_t> submitted_{0u};
+	std::atomic<std::uint64_t> executed_{0u};
+	std::atomic<std::uint64_t> dropped_{0u};
+	Buckets queueing_delay_{};
+	Buckets execution_time_{};
+};
+
+/**
+ * @brief MetricsScope
+ * Measures the execution of one task taken from the mailbox:
+ *  created right before the execution, destroyed right after.
+ * Does nothing if the mailbox has no metrics or metrics are disabled.
+ */
+class MetricsScope
+{
+public:
+#if THREAD_HIGHWAYS_METRICS
+	template <typename Holder>
+	MetricsScope(Metrics * metrics, const Holder & holder) noexcept
+		: metrics_{metrics}
+		, sent_at_{holder.sent_at_}
+		, start_{metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}}
+	{
+	}
+
+	~MetricsScope()
+	{
+		if (!metrics_)
+			return;
+		metrics_->on_executed(
+			sent_at_ == std::chrono::steady_clock::time_point{} ? std::chrono::nanoseconds{} : start_ - sent_at_,
+			std::chrono::steady_clock::now() - start_);
+	}
+#else
+	template <typename Holder>
+	MetricsScope(Metrics *, const Holder &) noexcept
+	{
+	}
+#endif
+
+	MetricsScope(const MetricsScope &) = delete;
+	MetricsScope & operator=(const MetricsScope &) = delete;
+
+#if THREAD_HIGHWAYS_METRICS
+private:
+	Metrics * const metrics_;
+	const std::chrono::steady_clock::time_point sent_at_;
+	const std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_METRICS_H
@@ -8,6 +8,7 @@
 #ifndef THREADS_HIGHWAYS_TOOLS_RAIITHREAD_H
 #define THREADS_HIGHWAYS_TOOLS_RAIITHREAD_H
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -25,6 +26,16 @@ public:
 	{
 	}
 
+	/**
+	 * @brief RAIIthread
+	 * For the threads started without std::thread (native thread with special attributes)
+	 * @param native_join - joins the native thread
+	 */
+	explicit RAIIthread(std::function<void()> native_join)
+		: bundle_(std::make_unique<Bundle>(std::move(native_join)))
+	{
+	}
+
 	~RAIIthread()
 	{
 		join();
@@ -73,6 +84,11 @@ private:
 			, joinable_{thread_.joinable()}
 		{
 		}
+		Bundle(std::function<void()> && native_join)
+			: native_join_{std::move(native_join)}
+			, joinable_{!!native_join_}
+		{
+		}
 		Bundle(Bundle &&) = delete;
 		Bundle & operator=(Bundle &&) = delete;
 		Bundle(const Bundle &) = delete;
@@ -89,12 +105,17 @@ private:
 			{
 				thread_.join();
 			}
+			else if (joinable_ && native_join_)
+			{
+				native_join_();
+			}
 			joinable_ = false;
 		}
 
 	private:
 		std::mutex mutex_;
 		std::thread thread_;
+		std::function<void()> native_join_;
 		bool joinable_{false};
 	};
 
@@ -0,0 +1,107 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_SCHEDULE_HEAP_H
+#define THREADS_HIGHWAYS_TOOLS_SCHEDULE_HEAP_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief ScheduleHeap
+ * Single threaded binary min-heap of scheduled task holders
+ * ordered by holder->t_.schedule().next_execution_time_.
+ * push - O(log n), next_execution_time - O(1), pop_expired - O(log n)
+ * @note the heap owns the holders: everything left inside is deleted in the destructor
+ */
+template <typename Holder>
+class ScheduleHeap
+{
+public:
+	ScheduleHeap() = default;
+	ScheduleHeap(const ScheduleHeap &) = delete;
+	ScheduleHeap & operator=(const ScheduleHeap &) = delete;
+
+	~ScheduleHeap()
+	{
+		clear();
+	}
+
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return heap_.empty();
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept
+	{
+		return heap_.size();
+	}
+
+	void push(Holder * holder)
+	{
+		if (!holder)
+			return;
+		heap_.push_back(holder);
+		std::push_heap(heap_.begin(), heap_.end(), later);
+	}
+
+	/**
+	 * @brief next_execution_time
+	 * @param if_empty - value returned when there are no scheduled tasks
+	 * @return time point of the nearest scheduled launch
+	 */
+	[[nodiscard]] std::chrono::steady_clock::time_point next_execution_time(
+		const std::chrono::steady_clock::time_point if_empty) const noexcept
+	{
+		if (heap_.empty())
+			return if_empty;
+		return heap_.front()->t_.schedule().next_execution_time_;
+	}
+
+	/**
+	 * @brief pop_expired
+	 * Extracting the nearest scheduled task if its time has come
+	 * @param time - current time
+	 * @return holder or nullptr
+	 */
+	[[nodiscard]] Holder * pop_expired(const std::chrono::steady_clock::time_point time)
+	{
+		if (heap_.empty() || heap_.front()->t_.schedule().next_execution_time_ > time)
+			return nullptr;
+		std::pop_heap(heap_.begin(), heap_.end(), later);
+		Holder * re = heap_.back();
+		heap_.pop_back();
+		return re;
+	}
+
+	void clear()
+	{
+		for (auto holder : heap_)
+		{
+			delete holder;
+		}
+		heap_.clear();
+	}
+
+private:
+	static bool later(Holder * lh, Holder * rh) noexcept
+	{
+		return lh->t_.schedule().next_execution_time_ > rh->t_.schedule().next_execution_time_;
+	}
+
+private:
+	std::vector<Holder *> heap_;
+}; // ScheduleHeap
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_SCHEDULE_HEAP_H
@@ -0,0 +1,17 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_SLAB_MEMORY_H
+#define THREADS_HIGHWAYS_TOOLS_SLAB_MEMORY_H
+
+#if __linux__ && !__ANDROID__
+#	include <thread_highways/tools/linux/slab_memory.h>
+#else
+#	include <thread_highways/tools/default/slab_memory.h>
+#endif
+
+#endif // THREADS_HIGHWAYS_TOOLS_SLAB_MEMORY_H
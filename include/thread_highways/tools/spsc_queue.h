@@ -0,0 +1,166 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_SPSC_QUEUE_H
+#define THREADS_HIGHWAYS_TOOLS_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace hi
+{
+
+/**
+ * @brief SpscQueue
+ * Bounded single-producer single-consumer lock-free queue (Lamport's ring):
+ *  no read-modify-write atomics, the producer and the consumer only store their own index (release)
+ *  and load the other one (acquire), and only when the cached copy is exhausted.
+ * @note one producer thread and one consumer thread at a time
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue(const std::uint32_t capacity = 1024u)
+		: capacity_{round_up_capacity(capacity)}
+		, mask_{capacity_ - 1u}
+		, slots_{new Slot[capacity_]}
+	{
+	}
+
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue & operator=(const SpscQueue &) = delete;
+
+	~SpscQueue()
+	{
+		const auto tail = tail_.load(std::memory_order_acquire);
+		for (auto head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+		{
+			item(head)->~T();
+		}
+	}
+
+	[[nodiscard]] std::uint32_t capacity() const noexcept
+	{
+		return static_cast<std::uint32_t>(capacity_);
+	}
+
+	/**
+	 * @brief try_push
+	 * Producer only
+	 * @param t - stays untouched if failed
+	 * @return false if the queue is full
+	 */
+	bool try_push(T && t)
+	{
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		if (tail - cached_head_ == capacity_)
+		{
+			cached_head_ = head_.load(std::memory_order_acquire);
+			if (tail - cached_head_ == capacity_)
+				return false;
+		}
+		new (&slots_[tail & mask_]) T{std::move(t)};
+		tail_.store(tail + 1u, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief pop_batch
+	 * Consumer only: extracting up to max_cnt items with one store of the consumer index
+	 * @param fun - called for each item (T &&); if it throws, the item is dropped and the rest stay in the queue
+	 * @param max_cnt - batch size limit
+	 * @return number of extracted items
+	 */
+	template <typename F>
+	std::uint32_t pop_batch(F && fun, const std::uint32_t max_cnt)
+	{
+		const auto head = head_.load(std::memory_order_relaxed);
+		if (cached_tail_ - head < max_cnt)
+		{
+			// the batch may be filled with what was published since the last look
+			cached_tail_ = tail_.load(std::memory_order_acquire);
+			if (head == cached_tail_)
+				return 0u;
+		}
+		const auto end = std::min<std::uint64_t>(cached_tail_, head + max_cnt);
+
+		// the consumed items are returned to the producer even if fun throws
+		struct Publish
+		{
+			~Publish()
+			{
+				head_.store(pos_, std::memory_order_release);
+			}
+			std::atomic<std::uint64_t> & head_;
+			std::uint64_t pos_;
+		} publish{head_, head};
+		struct Destroy
+		{
+			~Destroy()
+			{
+				item_->~T();
+			}
+			T * const item_;
+		};
+		while (publish.pos_ != end)
+		{
+			const Destroy destroy{item(publish.pos_)};
+			++publish.pos_;
+			fun(std::move(*destroy.item_));
+		}
+		return static_cast<std::uint32_t>(end - head);
+	}
+
+	// Any thread: approximate
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Slot
+	{
+		alignas(T) unsigned char data_[sizeof(T)];
+	};
+
+	static std::uint64_t round_up_capacity(const std::uint32_t capacity) noexcept
+	{
+		std::uint64_t re{1u};
+		while (re < capacity)
+		{
+			re <<= 1u;
+		}
+		return re;
+	}
+
+	T * item(const std::uint64_t pos) noexcept
+	{
+		return std::launder(reinterpret_cast<T *>(slots_[pos & mask_].data_));
+	}
+
+private:
+	const std::uint64_t capacity_;
+	const std::uint64_t mask_;
+	const std::unique_ptr<Slot[]> slots_;
+
+	// producer
+	alignas(64) std::atomic<std::uint64_t> tail_{0u};
+	std::uint64_t cached_head_{0u};
+
+	// consumer
+	alignas(64) std::atomic<std::uint64_t> head_{0u};
+	std::uint64_t cached_tail_{0u};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_SPSC_QUEUE_H
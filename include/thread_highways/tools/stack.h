@@ -8,12 +8,57 @@
 #ifndef THREADS_HIGHWAYS_TOOLS_STACK_H
 #define THREADS_HIGHWAYS_TOOLS_STACK_H
 
+#include <thread_highways/tools/metrics.h>
+
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <new>
+#include <type_traits>
 
 namespace hi
 {
 
+/**
+ * @brief HoldersSlab
+ * Header of a contiguous block of holders (see holders_slab.h):
+ *  the block is freed when the last of its holders is deleted.
+ */
+struct HoldersSlab
+{
+	void release() noexcept
+	{
+		if (alive_.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+		{
+			free_(this);
+		}
+	}
+
+	// Holders that are not yet deleted
+	std::atomic<std::uint32_t> alive_{0u};
+	std::size_t bytes_{0u};
+	bool huge_pages_{false};
+	void (*free_)(HoldersSlab *) noexcept {nullptr};
+};
+
+/**
+ * @brief SlabHolders
+ * The holders of T can be placed in slabs (see HoldersAllocation::slab_size_):
+ *  then every Holder<T> (also the ones allocated alone) is prefixed with its slab.
+ * On for the types that declare static constexpr bool slab_holders_ = true (the tasks of the highways),
+ *  or specialize it for the messages of your mailboxes with slabs.
+ */
+template <typename T, typename = void>
+struct SlabHolders : std::false_type
+{
+};
+
+template <typename T>
+struct SlabHolders<T, std::enable_if_t<T::slab_holders_>> : std::true_type
+{
+};
+
 template <typename T>
 struct Holder
 {
@@ -31,8 +76,71 @@ struct Holder
 	Holder & operator=(const Holder &) = delete;
 	Holder & operator=(Holder &&) = delete;
 
+	/*
+	 * With SlabHolders<T> every holder is prefixed with the slab it was placed in (nullptr == allocated alone),
+	 * so that a holder from a slab can be deleted like any other one.
+	 */
+	static void * operator new(const std::size_t size)
+	{
+		char * place{nullptr};
+		if constexpr (alignof(Holder) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			place = static_cast<char *>(::operator new(size + prefix_size(), std::align_val_t{alignof(Holder)}));
+		}
+		else
+		{
+			place = static_cast<char *>(::operator new(size + prefix_size()));
+		}
+		if constexpr (SlabHolders<T>::value)
+		{
+			place += prefix_size();
+			slab_of(place) = nullptr;
+		}
+		return place;
+	}
+
+	static void operator delete(void * ptr) noexcept
+	{
+		if (!ptr)
+			return;
+		if constexpr (SlabHolders<T>::value)
+		{
+			if (HoldersSlab * slab = slab_of(ptr))
+			{
+				slab->release();
+				return;
+			}
+		}
+		char * place = static_cast<char *>(ptr) - prefix_size();
+		if constexpr (alignof(Holder) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			::operator delete(place, std::align_val_t{alignof(Holder)});
+		}
+		else
+		{
+			::operator delete(place);
+		}
+	}
+
+	// Bytes before the holder (the holder stays aligned)
+	static constexpr std::size_t prefix_size() noexcept
+	{
+		if constexpr (!SlabHolders<T>::value)
+			return 0u;
+		return alignof(Holder) > sizeof(HoldersSlab *) ? alignof(Holder) : sizeof(HoldersSlab *);
+	}
+
+	static HoldersSlab *& slab_of(void * holder) noexcept
+	{
+		return *reinterpret_cast<HoldersSlab **>(static_cast<char *>(holder) - sizeof(HoldersSlab *));
+	}
+
 	T t_;
 	Holder * next_in_stack_{nullptr};
+#if THREAD_HIGHWAYS_METRICS
+	// When the holder was sent to the mailbox (for the queueing delay)
+	std::chrono::steady_clock::time_point sent_at_{};
+#endif
 };
 
 template <typename Holder>
@@ -200,6 +308,25 @@ public:
 		}
 	}
 
+	/**
+	 * Tread safe push of a pre-linked chain of holders with a single CAS.
+	 * @param first - new head of the stack
+	 * @param last - the end of the chain (last->next_in_stack_ will be overwritten)
+	 */
+	void push_chain(Holder * first, Holder * last) noexcept
+	{
+		if (!first || !last)
+			return;
+		last->next_in_stack_ = head_.load(std::memory_order_relaxed);
+		while (!head_.compare_exchange_weak(
+			last->next_in_stack_,
+			first,
+			std::memory_order_release,
+			std::memory_order_relaxed))
+		{
+		}
+	}
+
 	/**
 	 * Tread safe pop an object from the stack.
 	 * This method can only be used if the holders are not dallocated.
@@ -210,7 +337,7 @@ public:
 		/*
 		 * Here, if it freezes and another thread manages to destroy re,
 		 *  then there will be SIGSEGV on the call to re->next_in_stack_.
-		 * That's why I don't deallocate holders.
+		 * That's why I don't deallocate holders (or pin an epoch, see EpochReclamation).
 		 */
 		while (
 			re && // exits if stack is empty
@@ -352,7 +479,7 @@ public:
 		/*
 		 * Here, if it freezes and another thread manages to destroy re,
 		 *  then there will be SIGSEGV on the call to re->next_in_stack_.
-		 * That's why I don't deallocate holders.
+		 * That's why I don't deallocate holders (or pin an epoch, see EpochReclamation).
 		 */
 		while (
 			re && // exits if stack is empty
@@ -85,6 +85,12 @@ public:
 		return head_.load(std::memory_order_acquire) == aba_safe_pointer_null;
 	}
 
+	[[nodiscard]] bool has_free_holder() const noexcept
+	{
+		return free_head_.load(std::memory_order_acquire) != aba_safe_pointer_null
+			|| cur_allocation_id_.load(std::memory_order_acquire) < pool_.size();
+	}
+
 	[[nodiscard]] AbaSafeHolder<T> * allocate_holder()
 	{
 		AbaSafeHolder<T> * re = pop_use_head(free_head_);
@@ -0,0 +1,41 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_THREAD_PLACEMENT_H
+#define THREADS_HIGHWAYS_TOOLS_THREAD_PLACEMENT_H
+
+#if __linux__ && !__ANDROID__
+#	include <thread_highways/tools/linux/thread_placement.h>
+#else
+#	include <thread_highways/tools/default/thread_placement.h>
+#endif
+
+namespace hi
+{
+
+/**
+ * @brief placement_for
+ * Placement of one of the threads started with the same placement
+ * @param placement - common placement
+ * @param thread_number - sequence number of the thread
+ * @return if spread_across_cores_ then the placement pinned to one core, otherwise the common placement
+ */
+[[maybe_unused]] inline ThreadPlacement placement_for(const ThreadPlacement & placement, const std::uint32_t thread_number)
+{
+	if (!placement.spread_across_cores_)
+		return placement;
+	const auto cores = placement_cores(placement);
+	if (cores.empty())
+		return placement;
+	ThreadPlacement re{placement};
+	re.cores_ = {cores[thread_number % cores.size()]};
+	return re;
+}
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_THREAD_PLACEMENT_H
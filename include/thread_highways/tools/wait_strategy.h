@@ -0,0 +1,160 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_WAIT_STRATEGY_H
+#define THREADS_HIGHWAYS_TOOLS_WAIT_STRATEGY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	include <immintrin.h>
+#endif
+
+namespace hi
+{
+
+/**
+ * @brief WaitStrategy
+ * What the worker thread does when there are no tasks
+ */
+enum class WaitStrategy : std::uint8_t
+{
+	// Falls asleep on the mailbox event immediately (the cheapest for CPU, the longest wake-up)
+	Block,
+	// Bounded spin with pause, then yield, then falls asleep on the mailbox event.
+	// The spin length adapts to the recent hit rate of spinning.
+	SpinThenPark,
+	// Never falls asleep (for the dedicated cores only)
+	BusyPoll
+};
+
+// Hint to the processor that the thread is spinning
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief IdleWaiter
+ * Worker thread local state of the waiting for new tasks.
+ * The strategy is read on each wait, so it can be changed on the fly.
+ * On a single core SpinThenPark works as Block and BusyPoll yields instead of pause.
+ * Usage:
+ *  if (idle_waiter.spin(has_tasks, deadline)) take tasks without waiting
+ *  else wait on the mailbox event until deadline
+ */
+class IdleWaiter
+{
+public:
+	IdleWaiter(const std::atomic<WaitStrategy> & strategy)
+		: strategy_{strategy}
+	{
+	}
+
+	/**
+	 * @brief spin
+	 * Waiting for the condition without falling asleep (according to the strategy)
+	 * @param condition - what we are waiting for
+	 * @param deadline - no need to wait longer
+	 * @return true if the condition came true, false if it's time to fall asleep
+	 */
+	template <typename Condition>
+	bool spin(Condition && condition, const std::chrono::steady_clock::time_point deadline)
+	{
+		switch (strategy_.load(std::memory_order_relaxed))
+		{
+		case WaitStrategy::SpinThenPark:
+			// on a single core the producer can't run while we are spinning
+			return multi_core() ? spin_then_park(condition) : false;
+		case WaitStrategy::BusyPoll:
+			return busy_poll(condition, deadline);
+		case WaitStrategy::Block:
+		default:
+			return false;
+		}
+	}
+
+	[[nodiscard]] std::uint32_t spin_limit() const noexcept
+	{
+		return spin_limit_;
+	}
+
+private:
+	static bool multi_core() noexcept
+	{
+		static const bool re = std::thread::hardware_concurrency() > 1u;
+		return re;
+	}
+
+	template <typename Condition>
+	bool spin_then_park(Condition & condition)
+	{
+		for (std::uint32_t i = 0; i < spin_limit_; ++i)
+		{
+			if (condition())
+			{
+				// spinning pays off - spin longer next time
+				if (spin_limit_ < max_spin_limit_)
+					spin_limit_ *= 2u;
+				return true;
+			}
+			cpu_relax();
+		}
+
+		for (std::uint32_t i = 0; i < yield_limit_; ++i)
+		{
+			std::this_thread::yield();
+			if (condition())
+				return true;
+		}
+
+		// spinning was useless - spin less next time
+		if (spin_limit_ > min_spin_limit_)
+			spin_limit_ /= 2u;
+		return false;
+	}
+
+	template <typename Condition>
+	bool busy_poll(Condition & condition, const std::chrono::steady_clock::time_point deadline)
+	{
+		for (std::uint32_t i = 1u;; ++i)
+		{
+			if (condition())
+				return true;
+			if (multi_core())
+			{
+				cpu_relax();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+			// the clock is expensive in comparison with the condition check
+			if (i % 1024u == 0u && std::chrono::steady_clock::now() >= deadline)
+				return condition();
+		}
+	}
+
+private:
+	static constexpr std::uint32_t min_spin_limit_{8u};
+	static constexpr std::uint32_t max_spin_limit_{2048u};
+	static constexpr std::uint32_t yield_limit_{8u};
+
+	const std::atomic<WaitStrategy> & strategy_;
+	std::uint32_t spin_limit_{128u};
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_WAIT_STRATEGY_H
@@ -0,0 +1,267 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_WATCHDOG_H
+#define THREADS_HIGHWAYS_TOOLS_WATCHDOG_H
+
+#include <thread_highways/tools/coarse_clock.h>
+#include <thread_highways/tools/exception.h>
+#include <thread_highways/tools/raii_thread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief WatchedThread
+ * What the watched thread is executing right now.
+ * Written only by the watched thread (a few relaxed stores and a coarse clock stamp per task),
+ * read by the watchdog thread.
+ */
+class WatchedThread
+{
+public:
+	void task_started(const char * filename, const unsigned int line) noexcept
+	{
+		filename_.store(filename, std::memory_order_relaxed);
+		line_.store(line, std::memory_order_relaxed);
+		started_.store(coarse_now(), std::memory_order_relaxed);
+		// odd == a task is running
+		seq_.store(seq_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+	}
+
+	/**
+	 * @brief task_finished
+	 * @throw the exception thrown by the exception handler for the report about this thread
+	 *  (the watchdog thread does not swallow it, it is rethrown here as the handler was called by this thread)
+	 */
+	void task_finished()
+	{
+		seq_.store(seq_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+		if (has_failed_report_.load(std::memory_order_acquire))
+		{
+			rethrow_failed_report();
+		}
+	}
+
+private:
+	friend class Watchdog;
+
+	void set_failed_report(std::exception_ptr failed_report)
+	{
+		std::lock_guard lg{failed_report_mutex_};
+		failed_report_ = std::move(failed_report);
+		has_failed_report_.store(true, std::memory_order_release);
+	}
+
+	void rethrow_failed_report()
+	{
+		std::exception_ptr failed_report;
+		{
+			std::lock_guard lg{failed_report_mutex_};
+			failed_report = std::move(failed_report_);
+			failed_report_ = nullptr;
+			has_failed_report_.store(false, std::memory_order_relaxed);
+		}
+		if (failed_report)
+		{
+			std::rethrow_exception(failed_report);
+		}
+	}
+
+	std::atomic<std::uint64_t> seq_{0u};
+	// coarse_now() when the task was started
+	std::atomic<std::int64_t> started_{0};
+	std::atomic<const char *> filename_{nullptr};
+	std::atomic<unsigned int> line_{0u};
+
+	std::atomic<bool> has_failed_report_{false};
+	std::mutex failed_report_mutex_;
+	std::exception_ptr failed_report_;
+};
+
+/**
+ * @brief Watchdog
+ * Shared thread that detects stuck tasks while they are still running:
+ *  samples the watched threads, and if the same task is running longer than max_task_execution_time,
+ *  reports it (once per task) to the exception handler of the watched thread.
+ * The stuck time is measured from the start of the task (coarse clock: a few ms precision).
+ * @note the exception handler is called on the watchdog thread; if it throws (the default handler of HighWay does),
+ *  the exception is rethrown on the watched thread when the stuck task finishes (see WatchedThread::task_finished)
+ */
+class Watchdog
+{
+public:
+	Watchdog() = default;
+	Watchdog(const Watchdog &) = delete;
+	Watchdog & operator=(const Watchdog &) = delete;
+
+	~Watchdog()
+	{
+		destroy();
+	}
+
+	// One watchdog thread per process (started with the first watched thread)
+	static Watchdog & instance()
+	{
+		static Watchdog watchdog;
+		return watchdog;
+	}
+
+	/**
+	 * @brief watch
+	 * Registration of the thread to watch
+	 * @param name - for the report
+	 * @param max_task_execution_time - everything longer is reported
+	 * @param exception_handler - where to report
+	 * @return the thread marks the tasks there; watching stops when it is released
+	 */
+	std::shared_ptr<WatchedThread> watch(
+		std::string name,
+		const std::chrono::milliseconds max_task_execution_time,
+		ExceptionHandler exception_handler)
+	{
+		auto re = std::make_shared<WatchedThread>();
+		std::lock_guard lg{mutex_};
+		if (!keep_execution_)
+			return re;
+		watched_.emplace_back(Watched{re, std::move(name), max_task_execution_time, std::move(exception_handler)});
+		check_period_ = std::min(check_period_, period_for(max_task_execution_time));
+		if (!thread_started_)
+		{
+			thread_started_ = true;
+			thread_ = RAIIthread(std::thread(
+				[this]
+				{
+					watchdog_loop();
+				}));
+		}
+		cv_.notify_one();
+		return re;
+	}
+
+	void destroy()
+	{
+		{
+			std::lock_guard lg{mutex_};
+			keep_execution_ = false;
+		}
+		cv_.notify_one();
+		thread_.join();
+	}
+
+private:
+	struct Watched
+	{
+		std::weak_ptr<WatchedThread> thread_;
+		std::string name_;
+		std::chrono::milliseconds max_task_execution_time_;
+		ExceptionHandler exception_handler_;
+		// watchdog thread local:
+		std::uint64_t reported_seq_{0u};
+	};
+
+	struct Report
+	{
+		std::shared_ptr<WatchedThread> thread_;
+		ExceptionHandler exception_handler_;
+		hi::Exception exception_;
+	};
+
+	// The task is noticed at most one period late
+	static std::chrono::milliseconds period_for(const std::chrono::milliseconds max_task_execution_time)
+	{
+		return std::clamp<std::chrono::milliseconds>(
+			max_task_execution_time / 4,
+			std::chrono::milliseconds{1},
+			std::chrono::milliseconds{100});
+	}
+
+	void watchdog_loop()
+	{
+		std::unique_lock lk{mutex_};
+		while (keep_execution_)
+		{
+			cv_.wait_for(lk, check_period_);
+			if (!keep_execution_)
+				break;
+
+			const auto now = coarse_now();
+			std::vector<Report> reports;
+			auto new_period = std::chrono::milliseconds{100};
+			for (auto it = watched_.begin(); it != watched_.end();)
+			{
+				auto thread = it->thread_.lock();
+				if (!thread)
+				{
+					it = watched_.erase(it);
+					continue;
+				}
+				new_period = std::min(new_period, period_for(it->max_task_execution_time_));
+				const auto seq = thread->seq_.load(std::memory_order_acquire);
+				// odd == a task is running
+				if ((seq & 1u) && seq != it->reported_seq_)
+				{
+					const auto stuck_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+						std::chrono::nanoseconds{now - thread->started_.load(std::memory_order_relaxed)});
+					if (stuck_time >= it->max_task_execution_time_)
+					{
+						it->reported_seq_ = seq;
+						reports.emplace_back(Report{
+							thread,
+							it->exception_handler_,
+							hi::Exception{
+								it->name_ + ":Runnable:stuck for ms = " + std::to_string(stuck_time.count()),
+								thread->filename_.load(std::memory_order_relaxed),
+								thread->line_.load(std::memory_order_relaxed)}});
+					}
+				}
+				++it;
+			}
+			check_period_ = new_period;
+
+			// the handlers may be long: without the lock
+			lk.unlock();
+			for (auto & report : reports)
+			{
+				try
+				{
+					report.exception_handler_(report.exception_);
+				}
+				catch (...)
+				{
+					// the watchdog must keep watching the others: rethrown by the watched thread
+					report.thread_->set_failed_report(std::current_exception());
+				}
+			}
+			lk.lock();
+		}
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<Watched> watched_;
+	std::chrono::milliseconds check_period_{100};
+	bool keep_execution_{true};
+	bool thread_started_{false};
+	RAIIthread thread_;
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_WATCHDOG_H
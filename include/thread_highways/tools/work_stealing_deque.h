@@ -0,0 +1,162 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_TOOLS_WORK_STEALING_DEQUE_H
+#define THREADS_HIGHWAYS_TOOLS_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hi
+{
+
+/**
+ * @brief WorkStealingDeque
+ * Chase-Lev deque of pointers (the C11 version of Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013):
+ *  the owner thread pushes and pops at the bottom (LIFO),
+ *  any other thread steals from the top (FIFO).
+ * Grows without limit; the old arrays are kept until destruction (the thieves may still read them).
+ * @note the owner may change only with synchronization between the old and the new owner
+ */
+template <typename T>
+class WorkStealingDeque
+{
+public:
+	explicit WorkStealingDeque(const std::int64_t capacity = 256)
+	{
+		std::int64_t real_capacity{1};
+		while (real_capacity < capacity)
+		{
+			real_capacity <<= 1;
+		}
+		arrays_.emplace_back(std::make_unique<Array>(real_capacity));
+		array_.store(arrays_.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque(const WorkStealingDeque &) = delete;
+	WorkStealingDeque & operator=(const WorkStealingDeque &) = delete;
+
+	// Owner only
+	void push(T * item)
+	{
+		const auto bottom = bottom_.load(std::memory_order_relaxed);
+		const auto top = top_.load(std::memory_order_acquire);
+		Array * array = array_.load(std::memory_order_relaxed);
+		if (bottom - top > array->capacity_ - 1)
+		{
+			array = grow(array, top, bottom);
+		}
+		array->put(bottom, item);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	// Owner only: the last pushed item or nullptr
+	[[nodiscard]] T * pop()
+	{
+		const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+		Array * array = array_.load(std::memory_order_relaxed);
+		bottom_.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto top = top_.load(std::memory_order_relaxed);
+		if (top > bottom)
+		{
+			// empty
+			bottom_.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T * re = array->get(bottom);
+		if (top == bottom)
+		{
+			// the last item: race with the thieves
+			if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				re = nullptr;
+			}
+			bottom_.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return re;
+	}
+
+	// Any thread: the first pushed item or nullptr (if empty or lost the race)
+	[[nodiscard]] T * steal()
+	{
+		auto top = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto bottom = bottom_.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+		Array * array = array_.load(std::memory_order_acquire);
+		T * re = array->get(top);
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return re;
+	}
+
+	// Any thread: approximate
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+	}
+
+	// Any thread: approximate
+	[[nodiscard]] std::int64_t size() const noexcept
+	{
+		const auto re = bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed);
+		return re > 0 ? re : 0;
+	}
+
+private:
+	struct Array
+	{
+		explicit Array(const std::int64_t capacity)
+			: capacity_{capacity}
+			, mask_{capacity - 1}
+			, items_{std::make_unique<std::atomic<T *>[]>(static_cast<std::size_t>(capacity))}
+		{
+		}
+
+		T * get(const std::int64_t i) const noexcept
+		{
+			return items_[static_cast<std::size_t>(i & mask_)].load(std::memory_order_relaxed);
+		}
+
+		void put(const std::int64_t i, T * item) noexcept
+		{
+			items_[static_cast<std::size_t>(i & mask_)].store(item, std::memory_order_relaxed);
+		}
+
+		const std::int64_t capacity_;
+		const std::int64_t mask_;
+		std::unique_ptr<std::atomic<T *>[]> items_;
+	};
+
+	Array * grow(Array * array, const std::int64_t top, const std::int64_t bottom)
+	{
+		arrays_.emplace_back(std::make_unique<Array>(array->capacity_ * 2));
+		Array * re = arrays_.back().get();
+		for (auto i = top; i < bottom; ++i)
+		{
+			re->put(i, array->get(i));
+		}
+		array_.store(re, std::memory_order_release);
+		return re;
+	}
+
+private:
+	alignas(64) std::atomic<std::int64_t> top_{0};
+	alignas(64) std::atomic<std::int64_t> bottom_{0};
+	std::atomic<Array *> array_{nullptr};
+	// owner only
+	std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+} // namespace hi
+
+#endif // THREADS_HIGHWAYS_TOOLS_WORK_STEALING_DEQUE_H
@@ -0,0 +1,100 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <future>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	The producer sends burden tasks in batches of batch_size.
+	batch_size == 0 means a plain execute() for each task.
+*/
+template <typename Executor>
+bool test_batches(Executor & executor, const std::uint32_t burden, const std::uint32_t batch_size)
+{
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	std::atomic<std::uint32_t> executed{0};
+
+	auto make_task = [&]
+	{
+		return hi::Runnable::create(
+			[&]
+			{
+				if (++executed == burden)
+				{
+					complete_promise.set_value(true);
+				}
+			},
+			__FILE__,
+			__LINE__);
+	};
+
+	if (batch_size == 0)
+	{
+		for (std::uint32_t i = 0; i < burden; ++i)
+		{
+			executor.execute(make_task());
+		}
+	}
+	else
+	{
+		std::vector<hi::Runnable> batch;
+		batch.reserve(batch_size);
+		for (std::uint32_t i = 0; i < burden;)
+		{
+			for (std::uint32_t j = 0; j < batch_size && i < burden; ++j, ++i)
+			{
+				batch.emplace_back(make_task());
+			}
+			executor.execute_batch(std::move(batch));
+			batch.clear();
+		}
+	}
+
+	return complete_future.get();
+} // test_batches
+
+template <typename Executor>
+void main_test(Executor & executor, const std::string & executor_name)
+{
+	hi::CoutScope scope(std::string{"Start main_test for "}.append(executor_name));
+	const std::uint32_t burden{200000};
+	const std::uint32_t avg_times{5};
+	for (std::uint32_t batch_size : {0u, 1u, 8u, 64u, 512u})
+	{
+		std::chrono::nanoseconds execution_time{};
+		for (std::uint32_t i = 0; i < avg_times; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			if (!test_batches(executor, burden, batch_size))
+				return;
+			execution_time += std::chrono::steady_clock::now() - start;
+		}
+
+		scope.print(std::string{batch_size ? "execute_batch, batch size: " : "execute() for each task"}
+						.append(batch_size ? std::to_string(batch_size) : std::string{})
+						.append(", nanosec per task: ")
+						.append(std::to_string((execution_time / (avg_times * burden)).count())));
+	}
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	{
+		hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>()};
+		main_test(*highway.object_, "HighWay");
+	}
+	{
+		hi::RAIIdestroy plant{hi::make_self_shared<hi::MultiThreadedTaskProcessingPlant>(4u)};
+		main_test(*plant.object_, "MultiThreadedTaskProcessingPlant");
+	}
+	{
+		auto manager = hi::make_self_shared<hi::HighWaysManager>(4u, 1u);
+		main_test(*manager, "HighWaysManager");
+	}
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <future>
+#include <string>
+
+using namespace std::chrono_literals;
+
+/*
+	How the holders of the highway mailbox are allocated:
+	one `new` per holder on demand (default) vs contiguous slabs (on demand / prefaulted / on huge pages).
+	Measured: construction of the highway and the time until the first `burden` tasks are executed
+	(the first traffic of the default mailbox allocates the holders), then the same for the warmed up highway.
+*/
+std::chrono::nanoseconds execute_burden(hi::HighWay & highway, const std::uint32_t burden)
+{
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	std::uint32_t executed{0};
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::uint32_t i = 0; i < burden; ++i)
+	{
+		highway.execute(
+			[&]
+			{
+				if (++executed == burden)
+				{
+					complete_promise.set_value(true);
+				}
+			});
+	}
+	complete_future.get();
+	return std::chrono::steady_clock::now() - start;
+}
+
+void main_test(const std::string & test_name, const hi::HoldersAllocation & holders_allocation)
+{
+	hi::CoutScope scope(std::string{"Start main_test for "}.append(test_name));
+	const std::uint32_t capacity{65000};
+	const std::uint32_t burden{capacity};
+
+	const auto start = std::chrono::steady_clock::now();
+	hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>(
+		[](const hi::Exception & ex)
+		{
+			throw ex;
+		},
+		test_name,
+		std::chrono::milliseconds{},
+		capacity,
+		nullptr,
+		hi::PriorityLanes{},
+		hi::ThreadPlacement{},
+		nullptr,
+		holders_allocation)};
+	const auto startup_time = std::chrono::steady_clock::now() - start;
+
+	const auto first_time = execute_burden(*highway.object_, burden);
+	const auto warm_time = execute_burden(*highway.object_, burden);
+
+	scope.print(std::string{"startup microsec: "}
+					.append(std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(startup_time).count()))
+					.append(", first ")
+					.append(std::to_string(burden))
+					.append(" tasks nanosec per task: ")
+					.append(std::to_string((first_time / burden).count()))
+					.append(", warmed up nanosec per task: ")
+					.append(std::to_string((warm_time / burden).count()))
+					.append(", holders bytes: ")
+					.append(std::to_string(highway.object_->metrics().heap_usage_)));
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	main_test("one by one", hi::HoldersAllocation{});
+	main_test("slabs on demand", hi::HoldersAllocation{256u, false, false});
+	main_test("slabs prefaulted", hi::HoldersAllocation{256u, false, true});
+	main_test("slabs prefaulted on huge pages", hi::HoldersAllocation{4096u, true, true});
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <array>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	The same highway with different backends of the main mailbox:
+	MailBox (holders in the lock-free stacks) vs RingMailBox (contiguous ring, tasks executed in place).
+	producers_cnt threads send burden tasks, the task captures payload_size bytes
+	(up to hi::runnable_inline_size it is kept inline in the Runnable, bigger one goes to the heap).
+*/
+template <std::size_t payload_size, typename HighWay>
+bool test_producers(HighWay & highway, const std::uint32_t burden, const std::uint32_t producers_cnt)
+{
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	std::atomic<std::uint32_t> executed{0};
+
+	std::vector<std::thread> producers;
+	for (std::uint32_t producer = 0; producer < producers_cnt; ++producer)
+	{
+		producers.emplace_back(
+			[&]
+			{
+				std::array<char, payload_size> payload{};
+				for (std::uint32_t i = 0; i < burden / producers_cnt; ++i)
+				{
+					highway.execute(
+						[&, payload]
+						{
+							if (++executed + payload[0] == burden)
+							{
+								complete_promise.set_value(true);
+							}
+						});
+				}
+			});
+	}
+	for (auto & producer : producers)
+	{
+		producer.join();
+	}
+	return complete_future.get();
+} // test_producers
+
+template <std::size_t payload_size, typename HighWay>
+void test_payload(HighWay & highway, hi::CoutScope & scope)
+{
+	const std::uint32_t burden{240000};
+	const std::uint32_t avg_times{5};
+	for (std::uint32_t producers_cnt : {1u, 2u, 4u})
+	{
+		std::chrono::nanoseconds execution_time{};
+		for (std::uint32_t i = 0; i < avg_times; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			if (!test_producers<payload_size>(highway, burden, producers_cnt))
+				return;
+			execution_time += std::chrono::steady_clock::now() - start;
+		}
+
+		scope.print(std::string{"payload bytes: "}
+						.append(std::to_string(payload_size))
+						.append(", producers: ")
+						.append(std::to_string(producers_cnt))
+						.append(", nanosec per task: ")
+						.append(std::to_string((execution_time / (avg_times * burden)).count())));
+	}
+}
+
+template <typename HighWay>
+void main_test(const std::string & highway_name)
+{
+	hi::CoutScope scope(std::string{"Start main_test for "}.append(highway_name));
+	hi::RAIIdestroy highway{hi::make_self_shared<HighWay>(
+		[](const hi::Exception & ex)
+		{
+			throw ex;
+		},
+		highway_name,
+		std::chrono::milliseconds{},
+		4096u)};
+	test_payload<8>(*highway.object_, scope);
+	test_payload<32>(*highway.object_, scope);
+	test_payload<128>(*highway.object_, scope);
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	main_test<hi::HighWay>("HighWay (MailBox)");
+	main_test<hi::RingHighWay>("RingHighWay (RingMailBox)");
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
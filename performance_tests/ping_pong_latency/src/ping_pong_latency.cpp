@@ -0,0 +1,108 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	Request/response: the ping executor sends a task to the pong executor and the pong executor answers at once.
+	Between the round trips both executors are idle, so the round trip time shows the wake-up cost
+	of the wait strategy.
+*/
+template <typename Executor>
+bool test_ping_pong(
+	Executor & ping,
+	Executor & pong,
+	const std::uint32_t round_trips,
+	std::vector<std::chrono::nanoseconds> & latencies)
+{
+	latencies.clear();
+	latencies.reserve(round_trips);
+
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	std::chrono::steady_clock::time_point start;
+
+	std::function<void()> send_ping = [&]
+	{
+		start = std::chrono::steady_clock::now();
+		pong.execute(
+			[&]
+			{
+				ping.execute(
+					[&]
+					{
+						latencies.push_back(std::chrono::steady_clock::now() - start);
+						if (latencies.size() == round_trips)
+						{
+							complete_promise.set_value(true);
+							return;
+						}
+						// a pause so the pong executor goes idle
+						const auto pause_until = std::chrono::steady_clock::now() + 20us;
+						while (std::chrono::steady_clock::now() < pause_until)
+						{
+						}
+						send_ping();
+					});
+			});
+	};
+	ping.execute(
+		[&]
+		{
+			send_ping();
+		});
+
+	return complete_future.get();
+} // test_ping_pong
+
+std::string wait_strategy_name(hi::WaitStrategy wait_strategy)
+{
+	switch (wait_strategy)
+	{
+	case hi::WaitStrategy::Block:
+		return "Block";
+	case hi::WaitStrategy::SpinThenPark:
+		return "SpinThenPark";
+	case hi::WaitStrategy::BusyPoll:
+		return "BusyPoll";
+	}
+	return {};
+}
+
+template <typename Executor>
+void main_test(const std::string & executor_name)
+{
+	hi::CoutScope scope(std::string{"Start main_test for "}.append(executor_name));
+	const std::uint32_t round_trips{20000};
+	for (auto wait_strategy : {hi::WaitStrategy::Block, hi::WaitStrategy::SpinThenPark, hi::WaitStrategy::BusyPoll})
+	{
+		hi::RAIIdestroy ping{hi::make_self_shared<Executor>()};
+		hi::RAIIdestroy pong{hi::make_self_shared<Executor>()};
+		ping.object_->set_wait_strategy(wait_strategy);
+		pong.object_->set_wait_strategy(wait_strategy);
+
+		std::vector<std::chrono::nanoseconds> latencies;
+		if (!test_ping_pong(*ping.object_, *pong.object_, round_trips, latencies))
+			return;
+
+		std::sort(latencies.begin(), latencies.end());
+		scope.print(std::string{wait_strategy_name(wait_strategy)}
+						.append(": round trip nanosec p50: ")
+						.append(std::to_string(latencies[latencies.size() / 2].count()))
+						.append(", p99: ")
+						.append(std::to_string(latencies[latencies.size() * 99 / 100].count())));
+	}
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	main_test<hi::HighWay>("HighWay");
+	main_test<hi::MultiThreadedTaskProcessingPlant>("MultiThreadedTaskProcessingPlant");
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	The producer keeps a backlog of bulk tasks (about 1 microsecond each) in the main mailbox,
+	meanwhile urgent tasks are sent with Priority{1}.
+	The time from the sending of an urgent task to its start is measured.
+*/
+bool test_urgent_latency(
+	hi::PriorityLanes priority_lanes,
+	const std::uint32_t urgent_cnt,
+	std::vector<std::chrono::nanoseconds> & latencies)
+{
+	const std::uint32_t bulk_backlog{10000};
+	hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>(
+		[](const hi::Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		bulk_backlog,
+		nullptr,
+		std::move(priority_lanes))};
+
+	std::atomic<bool> keep_bulk{true};
+	std::thread bulk_producer(
+		[&]
+		{
+			while (keep_bulk.load(std::memory_order_relaxed))
+			{
+				// blocks when the backlog is full
+				highway.object_->execute(
+					[]
+					{
+						const auto until = std::chrono::steady_clock::now() + 1us;
+						while (std::chrono::steady_clock::now() < until)
+						{
+						}
+					});
+			}
+		});
+
+	// the backlog is filled
+	std::this_thread::sleep_for(50ms);
+
+	latencies.clear();
+	latencies.reserve(urgent_cnt);
+	for (std::uint32_t i = 0; i < urgent_cnt; ++i)
+	{
+		std::promise<void> started;
+		auto started_future = started.get_future();
+		const auto send_time = std::chrono::steady_clock::now();
+		highway.object_->execute(
+			hi::Priority{1},
+			[&]
+			{
+				latencies.push_back(std::chrono::steady_clock::now() - send_time);
+				started.set_value();
+			});
+		if (started_future.wait_for(10s) != std::future_status::ready)
+		{
+			keep_bulk = false;
+			bulk_producer.join();
+			return false;
+		}
+		std::this_thread::sleep_for(200us);
+	}
+
+	keep_bulk = false;
+	bulk_producer.join();
+	return true;
+} // test_urgent_latency
+
+int main(int /* argc */, char ** /* argv */)
+{
+	struct TestBundle
+	{
+		hi::PriorityLanes priority_lanes;
+		std::string name;
+	};
+	std::vector<TestBundle> bundles{
+		{hi::PriorityLanes{}, "no lanes (urgent tasks queue behind bulk)"},
+		{hi::PriorityLanes{hi::PriorityLanes::Order::Strict, 1u, {{}}}, "Strict"},
+		{hi::PriorityLanes{hi::PriorityLanes::Order::WeightedRoundRobin, 8u, {{65000u, 1u}}},
+		 "WeightedRoundRobin 1:8"}};
+
+	hi::CoutScope scope("Start main_test: latency of urgent tasks under bulk load");
+	const std::uint32_t urgent_cnt{500};
+	for (auto && it : bundles)
+	{
+		std::vector<std::chrono::nanoseconds> latencies;
+		if (!test_urgent_latency(it.priority_lanes, urgent_cnt, latencies))
+			return 1;
+
+		std::sort(latencies.begin(), latencies.end());
+		scope.print(std::string{it.name}
+						.append(": microsec p50: ")
+						.append(std::to_string(
+							std::chrono::duration_cast<std::chrono::microseconds>(latencies[latencies.size() / 2]).count()))
+						.append(", p99: ")
+						.append(std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(
+												   latencies[latencies.size() * 99 / 100])
+												   .count()))
+						.append(", max: ")
+						.append(std::to_string(
+							std::chrono::duration_cast<std::chrono::microseconds>(latencies.back()).count())));
+	}
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
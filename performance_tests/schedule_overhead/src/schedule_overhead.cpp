@@ -0,0 +1,148 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	Each of the scheduled_cnt periodic tasks is launched launches_cnt times with the period.
+	The launches are evenly spread over the period (1 microsecond budget per launch),
+	so the time spent by the highway to find the next task to launch shows up as launch lateness.
+*/
+template <typename HighWayType>
+bool test_periodic_tasks(const std::uint32_t scheduled_cnt, std::chrono::nanoseconds & avg_lateness)
+{
+	const std::uint32_t launches_cnt{5};
+	const auto period = std::max<std::chrono::nanoseconds>(10ms, scheduled_cnt * 1us);
+
+	hi::RAIIdestroy highway{hi::make_self_shared<HighWayType>()};
+
+	// highway thread local:
+	std::uint64_t remaining_launches{std::uint64_t{scheduled_cnt} * launches_cnt};
+	std::chrono::nanoseconds lateness_sum{};
+	std::int64_t lateness_cnt{0};
+
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+
+	const auto start = std::chrono::steady_clock::now() + 100ms;
+	for (std::uint32_t i = 0; i < scheduled_cnt; ++i)
+	{
+		highway.object_->schedule(
+			[&, launches = 0u](hi::Schedule & schedule) mutable
+			{
+				const auto now = std::chrono::steady_clock::now();
+				if (launches)
+				{
+					// first launch lateness includes the time of scheduling all tasks
+					lateness_sum += now - schedule.next_execution_time_;
+					++lateness_cnt;
+				}
+				if (++launches < launches_cnt)
+				{
+					schedule.rechedule_ = true;
+					schedule.next_execution_time_ = now + period;
+				}
+				if (--remaining_launches == 0)
+				{
+					complete_promise.set_value(true);
+				}
+			},
+			start + period * i / scheduled_cnt,
+			__FILE__,
+			__LINE__);
+	}
+
+	if (!complete_future.get())
+		return false;
+	avg_lateness = lateness_cnt ? lateness_sum / lateness_cnt : std::chrono::nanoseconds{};
+	return true;
+} // test_periodic_tasks
+
+/*
+	Ordinary tasks are executed while scheduled_cnt tasks are waiting for their time.
+*/
+template <typename HighWayType>
+bool test_execute_with_pending_schedules(const std::uint32_t scheduled_cnt, std::chrono::nanoseconds & per_task)
+{
+	const std::uint32_t burden{100000};
+	hi::RAIIdestroy highway{hi::make_self_shared<HighWayType>()};
+
+	// Pending tasks are waiting for their time in an hour,
+	// and the ticker launched every millisecond forces the highway to look for the next task to launch
+	const auto start = std::chrono::steady_clock::now() + 1h;
+	for (std::uint32_t i = 0; i < scheduled_cnt; ++i)
+	{
+		highway.object_->schedule(
+			[](hi::Schedule &)
+			{
+			},
+			start + i * 1us,
+			__FILE__,
+			__LINE__);
+	}
+	highway.object_->schedule(
+		[](hi::Schedule & schedule)
+		{
+			schedule.schedule_launch_in(1ms);
+		},
+		{},
+		__FILE__,
+		__LINE__);
+	highway.object_->flush_tasks();
+
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+
+	const auto begin = std::chrono::steady_clock::now();
+	for (std::uint32_t i = 0; i <= burden; ++i)
+	{
+		highway.object_->execute(
+			[&, i]
+			{
+				if (i == burden)
+				{
+					complete_promise.set_value(true);
+				}
+			});
+	}
+	if (!complete_future.get())
+		return false;
+	per_task = (std::chrono::steady_clock::now() - begin) / std::int64_t{burden};
+	return true;
+} // test_execute_with_pending_schedules
+
+template <typename HighWayType>
+void main_test(const std::string & highway_name)
+{
+	hi::CoutScope scope(std::string{"Start main_test for "}.append(highway_name));
+	for (std::uint32_t scheduled_cnt : {10u, 100u, 1000u, 10000u, 100000u, 1000000u})
+	{
+		std::chrono::nanoseconds avg_lateness{};
+		if (!test_periodic_tasks<HighWayType>(scheduled_cnt, avg_lateness))
+			return;
+
+		std::chrono::nanoseconds per_task{};
+		if (!test_execute_with_pending_schedules<HighWayType>(scheduled_cnt, per_task))
+			return;
+
+		scope.print(std::string{"scheduled tasks: "}
+						.append(std::to_string(scheduled_cnt))
+						.append(", avg launch lateness microsec: ")
+						.append(std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(avg_lateness).count()))
+						.append(", execute() nanosec per task with pending schedules: ")
+						.append(std::to_string(per_task.count())));
+	}
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	main_test<hi::HighWay>("HighWay");
+	main_test<hi::HighWayAbaSafe>("HighWayAbaSafe");
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
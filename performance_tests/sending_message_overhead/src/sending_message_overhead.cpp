@@ -1,5 +1,6 @@
 #include <thread_highways/include_all.h>
 #include <thread_highways/tools/cout_scope.h>
+#include <thread_highways/tools/semaphore.h>
 
 #include <condition_variable>
 #include <future>
@@ -107,7 +108,7 @@ bool test_highway_channel_not_block(const std::uint32_t burden)
 	std::promise<bool> complete_promise;
 	auto complete_future = complete_promise.get_future();
 	hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>()};
-	highway.object_->set_capacity(burden);
+	highway.object_->set_capacity(burden + 1);
 
 	auto publisher = hi::make_self_shared<hi::PublishOneForMany<std::uint32_t>>();
 
@@ -157,6 +158,47 @@ bool test_highway_channel_direct_send(const std::uint32_t burden)
 	return complete_future.get();
 } // test_highway_channel_direct_send
 
+/*
+	One producer and one consumer on a raw MailBox with a small capacity:
+	both the consumer (waiting for messages) and the producer (waiting for holders) fall asleep,
+	so the cost of the wake-up mechanism (Event) shows up.
+*/
+template <typename Event>
+bool test_mail_box(const std::uint32_t burden)
+{
+	hi::MailBox<hi::Runnable, Event> mail_box;
+	mail_box.set_capacity(64);
+
+	const std::atomic<bool> keep_execution{true};
+	std::uint32_t last_received{0};
+	std::thread consumer(
+		[&]
+		{
+			while (auto holder = mail_box.pop_message())
+			{
+				holder->t_.run(keep_execution);
+				mail_box.free_holder(holder);
+				if (last_received == burden)
+					return;
+			}
+		});
+
+	for (std::uint32_t msg = 0; msg <= burden; ++msg)
+	{
+		mail_box.send_may_blocked(hi::Runnable::create(
+			[&, msg]
+			{
+				last_received = msg;
+			},
+			__FILE__,
+			__LINE__));
+	}
+
+	consumer.join();
+	mail_box.destroy();
+	return last_received == burden;
+} // test_mail_box
+
 struct TestBundle
 {
 	std::function<bool(const std::uint32_t)> fun;
@@ -198,6 +240,8 @@ int main(int /* argc */, char ** /* argv */)
 		TestBundle{test_highway_channel_block_on_wait_holder, "test_highway_channel_block_on_wait_holder", 0us});
 	funs.emplace_back(TestBundle{test_highway_channel_not_block, "test_highway_channel_not_block", 0us});
 	funs.emplace_back(TestBundle{test_highway_channel_direct_send, "test_highway_channel_direct_send", 0us});
+	funs.emplace_back(TestBundle{test_mail_box<hi::Semaphore>, "test_mail_box<Semaphore>", 0us});
+	funs.emplace_back(TestBundle{test_mail_box<hi::EventCount>, "test_mail_box<EventCount>", 0us});
 
 	main_test(funs, 10000);
 	main_test(funs, 100000);
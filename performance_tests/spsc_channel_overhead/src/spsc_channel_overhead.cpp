@@ -0,0 +1,127 @@
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/cout_scope.h>
+
+#include <future>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/*
+	One producer highway sends burden messages to one consumer highway:
+	PublishOneForMany with a subscription on the consumer highway (a Runnable in a holder per message, CAS on the
+   mailbox) vs SpscChannel (the messages go through SpscQueue and are read by the consumer in batches).
+*/
+bool test_publish_one_for_many(const std::uint32_t burden)
+{
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	hi::RAIIdestroy producer{hi::make_self_shared<hi::HighWay>()};
+	hi::RAIIdestroy consumer{hi::make_self_shared<hi::HighWay>()};
+
+	auto publisher = hi::make_self_shared<hi::PublishOneForMany<std::uint32_t>>();
+	auto subsciption = publisher->subscribe_channel()->subscribe(
+		[&](std::uint32_t publication)
+		{
+			if (publication == burden)
+			{
+				complete_promise.set_value(true);
+			}
+		},
+		consumer.object_,
+		__FILE__,
+		__LINE__,
+		false,
+		false);
+
+	producer.object_->execute(
+		[&]
+		{
+			for (std::uint32_t msg = 0; msg <= burden; ++msg)
+			{
+				publisher->publish(msg);
+			}
+		});
+
+	return complete_future.get();
+} // test_publish_one_for_many
+
+template <std::uint32_t max_batch>
+bool test_spsc_channel(const std::uint32_t burden)
+{
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	hi::RAIIdestroy producer{hi::make_self_shared<hi::HighWay>()};
+	hi::RAIIdestroy consumer{hi::make_self_shared<hi::HighWay>()};
+
+	hi::SpscChannel<std::uint32_t> channel{
+		[&](std::uint32_t publication)
+		{
+			if (publication == burden)
+			{
+				complete_promise.set_value(true);
+			}
+		},
+		consumer.object_,
+		__FILE__,
+		__LINE__,
+		1024u,
+		max_batch};
+
+	producer.object_->execute(
+		[&]
+		{
+			for (std::uint32_t msg = 0; msg <= burden; ++msg)
+			{
+				channel.publish(msg);
+			}
+		});
+
+	return complete_future.get();
+} // test_spsc_channel
+
+struct TestBundle
+{
+	std::function<bool(const std::uint32_t)> fun;
+	std::string fun_name;
+	std::chrono::microseconds execution_time;
+};
+
+void main_test(std::vector<TestBundle> & funs, const std::uint32_t burden)
+{
+	hi::CoutScope scope(std::string{"Start main_test for burden="}.append(std::to_string(burden)));
+	const std::uint32_t avg_times{10};
+	for (std::uint32_t i = 0; i < avg_times; ++i)
+	{
+		for (auto && it : funs)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			if (!it.fun(burden))
+				return;
+			const auto finish = std::chrono::steady_clock::now();
+			it.execution_time += std::chrono::duration_cast<std::chrono::microseconds>(finish - start);
+		}
+	}
+
+	for (auto && it : funs)
+	{
+		scope.print(std::string{it.fun_name}
+						.append(" execution_time microsec per 100 messages: ")
+						.append(std::to_string((it.execution_time / (avg_times * burden / 100)).count())));
+		it.execution_time = 0us;
+	}
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+	std::vector<TestBundle> funs;
+
+	funs.emplace_back(TestBundle{test_publish_one_for_many, "test_publish_one_for_many", 0us});
+	funs.emplace_back(TestBundle{test_spsc_channel<1>, "test_spsc_channel<max_batch=1>", 0us});
+	funs.emplace_back(TestBundle{test_spsc_channel<64>, "test_spsc_channel<max_batch=64>", 0us});
+
+	main_test(funs, 10000);
+	main_test(funs, 100000);
+
+	std::cout << "Test finished" << std::endl;
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+/*
+ * Replacement of the whole set of the global allocation functions: plain, array, nothrow and align_val_t.
+ * Kept in its own translation unit, so the compiler does not inline them into the new/delete expressions
+ *  of the benchmark (and does not pair malloc/free with operator new/delete).
+ */
+
+#include "allocations_counter.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+std::atomic<std::uint64_t> allocations_counter{0};
+
+namespace
+{
+
+void * counted_alloc(const std::size_t size, const std::size_t alignment) noexcept
+{
+	allocations_counter.fetch_add(1, std::memory_order_relaxed);
+	if (alignment <= alignof(std::max_align_t))
+		return std::malloc(size ? size : 1);
+	// aligned_alloc wants the size to be a multiple of the alignment
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void * counted_alloc_or_throw(const std::size_t size, const std::size_t alignment)
+{
+	if (void * ptr = counted_alloc(size, alignment))
+		return ptr;
+	throw std::bad_alloc{};
+}
+
+} // namespace
+
+void * operator new(std::size_t size)
+{
+	return counted_alloc_or_throw(size, alignof(std::max_align_t));
+}
+
+void * operator new[](std::size_t size)
+{
+	return counted_alloc_or_throw(size, alignof(std::max_align_t));
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+	return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void * ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
@@ -0,0 +1,17 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#ifndef THREADS_HIGHWAYS_PERFORMANCE_TESTS_ALLOCATIONS_COUNTER_H
+#define THREADS_HIGHWAYS_PERFORMANCE_TESTS_ALLOCATIONS_COUNTER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Heap allocations made by all the forms of the global operator new (see allocations_counter.cpp)
+extern std::atomic<std::uint64_t> allocations_counter;
+
+#endif // THREADS_HIGHWAYS_PERFORMANCE_TESTS_ALLOCATIONS_COUNTER_H
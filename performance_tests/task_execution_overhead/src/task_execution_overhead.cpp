@@ -1,6 +1,9 @@
+#include "allocations_counter.h"
+
 #include <thread_highways/include_all.h>
 #include <thread_highways/tools/cout_scope.h>
 
+#include <array>
 #include <condition_variable>
 #include <future>
 #include <mutex>
@@ -181,7 +184,7 @@ bool test_highway_block_on_wait_holder(const std::uint32_t burden)
 bool test_highway_not_block(const std::uint32_t burden)
 {
 	hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>()};
-	highway.object_->set_capacity(burden);
+	highway.object_->set_capacity(burden + 1);
 
 	std::atomic<std::uint32_t> counter{0};
 	std::promise<bool> complete_promise;
@@ -203,11 +206,42 @@ bool test_highway_not_block(const std::uint32_t burden)
 	return complete_future.get();
 } // test_highway_not_block
 
+/*
+	The task does not fit into the inline buffer of the Runnable,
+	so each task costs a heap allocation (as it was for all tasks before the inline buffer).
+*/
+bool test_highway_big_task_not_block(const std::uint32_t burden)
+{
+	hi::RAIIdestroy highway{hi::make_self_shared<hi::HighWay>()};
+	highway.object_->set_capacity(burden + 1);
+
+	std::atomic<std::uint32_t> counter{0};
+	std::promise<bool> complete_promise;
+	auto complete_future = complete_promise.get_future();
+	const std::array<std::uint32_t, hi::runnable_inline_size> big_capture{};
+
+	for (std::uint32_t i = 0; i <= burden; ++i)
+	{
+		highway.object_->try_execute(
+			[&, big_capture]
+			{
+				const auto cur = counter.fetch_add(1 + big_capture[0]);
+				if (cur == burden)
+				{
+					complete_promise.set_value(true);
+				}
+			});
+	}
+
+	return complete_future.get();
+} // test_highway_big_task_not_block
+
 struct TestBundle
 {
 	std::function<bool(const std::uint32_t)> fun;
 	std::string fun_name;
 	std::chrono::microseconds execution_time;
+	std::uint64_t allocations{0};
 };
 
 void main_test(std::vector<TestBundle> & funs, const std::uint32_t burden)
@@ -218,11 +252,13 @@ void main_test(std::vector<TestBundle> & funs, const std::uint32_t burden)
 	{
 		for (auto && it : funs)
 		{
+			const auto allocations_before = allocations_counter.load(std::memory_order_relaxed);
 			const auto start = std::chrono::steady_clock::now();
 			if (!it.fun(burden))
 				return;
 			const auto finish = std::chrono::steady_clock::now();
 			it.execution_time += std::chrono::duration_cast<std::chrono::microseconds>(finish - start);
+			it.allocations += allocations_counter.load(std::memory_order_relaxed) - allocations_before;
 		}
 	}
 
@@ -230,8 +266,11 @@ void main_test(std::vector<TestBundle> & funs, const std::uint32_t burden)
 	{
 		scope.print(std::string{it.fun_name}
 						.append(" execution_time microsec per 100 tasks: ")
-						.append(std::to_string((it.execution_time / (avg_times * burden / 100)).count())));
+						.append(std::to_string((it.execution_time / (avg_times * burden / 100)).count()))
+						.append(", heap allocations per 100 tasks: ")
+						.append(std::to_string(it.allocations / (avg_times * burden / 100))));
 		it.execution_time = 0us;
+		it.allocations = 0;
 	}
 }
 
@@ -243,6 +282,7 @@ int main(int /* argc */, char ** /* argv */)
 	funs.emplace_back(TestBundle{test_std_thread_v2, "test_std_thread_v2", 0us});
 	funs.emplace_back(TestBundle{test_highway_block_on_wait_holder, "test_highway_block_on_wait_holder", 0us});
 	funs.emplace_back(TestBundle{test_highway_not_block, "test_highway_not_block", 0us});
+	funs.emplace_back(TestBundle{test_highway_big_task_not_block, "test_highway_big_task_not_block", 0us});
 
 	main_test(funs, 100000);
 	main_test(funs, 10000);
@@ -0,0 +1,227 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+TEST(TestSpscQueue, PushPopBatches)
+{
+	SpscQueue<std::string> queue{4u};
+	EXPECT_EQ(4u, queue.capacity());
+	EXPECT_TRUE(queue.empty());
+	for (std::uint32_t i = 0; i < 4; ++i)
+	{
+		EXPECT_TRUE(queue.try_push(std::to_string(i)));
+	}
+	std::string rejected{"4"};
+	EXPECT_FALSE(queue.try_push(std::move(rejected)));
+	EXPECT_EQ("4", rejected);
+
+	std::vector<std::string> popped;
+	const auto pop = [&](std::string && s)
+	{
+		popped.emplace_back(std::move(s));
+	};
+	EXPECT_EQ(3u, queue.pop_batch(pop, 3u));
+	EXPECT_TRUE(queue.try_push(std::move(rejected)));
+	EXPECT_EQ(2u, queue.pop_batch(pop, 10u));
+	EXPECT_EQ(0u, queue.pop_batch(pop, 10u));
+	EXPECT_TRUE(queue.empty());
+	EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "3", "4"}), popped);
+}
+
+TEST(TestSpscQueue, ThrowingConsumerDropsOnlyOneItem)
+{
+	SpscQueue<std::uint32_t> queue{8u};
+	for (std::uint32_t i = 0; i < 5; ++i)
+	{
+		EXPECT_TRUE(queue.try_push(std::uint32_t{i}));
+	}
+	std::vector<std::uint32_t> popped;
+	EXPECT_THROW(
+		queue.pop_batch(
+			[&](std::uint32_t i)
+			{
+				if (i == 2)
+					throw std::runtime_error("2");
+				popped.push_back(i);
+			},
+			10u),
+		std::runtime_error);
+	EXPECT_EQ(2u,
+		queue.pop_batch(
+			[&](std::uint32_t i)
+			{
+				popped.push_back(i);
+			},
+			10u));
+	EXPECT_EQ((std::vector<std::uint32_t>{0, 1, 3, 4}), popped);
+}
+
+TEST(TestSpscQueue, ProducerAndConsumerThreads)
+{
+	SpscQueue<std::uint64_t> queue{16u};
+	const std::uint64_t messages_cnt{100000};
+	std::thread producer(
+		[&]
+		{
+			for (std::uint64_t i = 0; i < messages_cnt;)
+			{
+				if (queue.try_push(std::uint64_t{i}))
+				{
+					++i;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+	std::uint64_t expected{0};
+	while (expected < messages_cnt)
+	{
+		if (!queue.pop_batch(
+				[&](std::uint64_t i)
+				{
+					EXPECT_EQ(expected, i);
+					++expected;
+				},
+				7u))
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(TestSpscChannel, HighWayToHighWayInOrder)
+{
+	RAIIdestroy producer{make_self_shared<HighWay>()};
+	RAIIdestroy consumer{make_self_shared<HighWay>()};
+
+	const std::uint32_t messages_cnt{10000};
+	std::promise<std::thread::id> consumer_thread;
+	consumer.object_->execute(
+		[&]
+		{
+			consumer_thread.set_value(std::this_thread::get_id());
+		});
+	const auto consumer_thread_id = consumer_thread.get_future().get();
+
+	std::vector<std::uint32_t> received;
+	std::promise<bool> all_received;
+	auto channel = std::make_shared<SpscChannel<std::uint32_t>>(
+		[&](std::uint32_t publication)
+		{
+			EXPECT_EQ(consumer_thread_id, std::this_thread::get_id());
+			received.push_back(publication);
+			if (received.size() == messages_cnt)
+			{
+				all_received.set_value(true);
+			}
+		},
+		consumer.object_,
+		__FILE__,
+		__LINE__,
+		64u,
+		16u);
+
+	producer.object_->execute(
+		[&, channel]
+		{
+			for (std::uint32_t i = 0; i < messages_cnt; ++i)
+			{
+				channel->publish(i);
+			}
+		});
+	EXPECT_EQ(std::future_status::ready, all_received.get_future().wait_for(10s));
+	ASSERT_EQ(messages_cnt, received.size());
+	for (std::uint32_t i = 0; i < messages_cnt; ++i)
+	{
+		EXPECT_EQ(i, received[i]);
+	}
+}
+
+TEST(TestSpscChannel, ClosedChannelIsDrained)
+{
+	RAIIdestroy consumer{make_self_shared<HighWay>()};
+	std::promise<bool> release;
+	auto release_future = release.get_future().share();
+	consumer.object_->execute(
+		[release_future]
+		{
+			release_future.wait();
+		});
+
+	std::vector<std::string> received;
+	{
+		SpscChannel<std::string> channel{
+			[&](std::string publication, const std::atomic<bool> &)
+			{
+				received.emplace_back(std::move(publication));
+			},
+			consumer.object_,
+			__FILE__,
+			__LINE__,
+			4u};
+		EXPECT_TRUE(channel.try_publish("a"));
+		EXPECT_TRUE(channel.try_publish("b"));
+		EXPECT_TRUE(channel.try_publish("c"));
+		EXPECT_TRUE(channel.try_publish("d"));
+		// the consumer is busy
+		EXPECT_FALSE(channel.try_publish("e"));
+	}
+	release.set_value(true);
+	consumer.object_->flush_tasks();
+	EXPECT_EQ((std::vector<std::string>{"a", "b", "c", "d"}), received);
+}
+
+TEST(TestSpscChannel, ExceptionGoesToHandler)
+{
+	std::promise<std::string> handled;
+	RAIIdestroy consumer{make_self_shared<HighWay>(
+		[&](const Exception & ex)
+		{
+			handled.set_value(ex.what());
+		})};
+
+	std::promise<std::uint32_t> next;
+	SpscChannel<std::uint32_t> channel{
+		[&](std::uint32_t publication)
+		{
+			if (publication == 0)
+				throw std::runtime_error("bad publication");
+			next.set_value(publication);
+		},
+		consumer.object_,
+		__FILE__,
+		__LINE__};
+	channel.publish(0);
+	channel.publish(1);
+	auto handled_future = handled.get_future();
+	ASSERT_EQ(std::future_status::ready, handled_future.wait_for(5s));
+	auto next_future = next.get_future();
+	ASSERT_EQ(std::future_status::ready, next_future.wait_for(5s));
+	EXPECT_EQ(1u, next_future.get());
+}
+
+} // namespace hi
@@ -9,6 +9,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <type_traits>
+
 namespace hi
 {
 namespace
@@ -114,5 +117,125 @@ TEST_P(RunnableCallbacksTest, RunAndWaitResultDirect)
 	highway->destroy();
 }
 
+struct DestroyCounter
+{
+	DestroyCounter(std::atomic<int> & alive)
+		: alive_{&alive}
+	{
+		++(*alive_);
+	}
+	DestroyCounter(DestroyCounter && rhs) noexcept
+		: alive_{rhs.alive_}
+	{
+		++(*alive_);
+	}
+	DestroyCounter(const DestroyCounter &) = delete;
+	DestroyCounter & operator=(const DestroyCounter &) = delete;
+	DestroyCounter & operator=(DestroyCounter &&) = delete;
+	~DestroyCounter()
+	{
+		--(*alive_);
+	}
+	std::atomic<int> * alive_;
+};
+
+TEST(RunnableInlineStorage, SmallTaskIsInline)
+{
+	std::atomic<int> alive{0};
+	std::atomic<int> launches{0};
+	{
+		auto runnable = Runnable::create(
+			[&, counter = DestroyCounter{alive}]
+			{
+				++launches;
+			},
+			__FILE__,
+			__LINE__);
+		EXPECT_TRUE(runnable.is_inline());
+		EXPECT_EQ(1, alive);
+
+		Runnable moved{std::move(runnable)};
+		EXPECT_TRUE(moved.is_inline());
+		EXPECT_FALSE(runnable.is_inline());
+		EXPECT_EQ(1, alive);
+
+		Runnable assigned;
+		assigned = std::move(moved);
+		EXPECT_EQ(1, alive);
+		assigned.run(std::atomic<bool>{true});
+		EXPECT_EQ(1, launches);
+	}
+	EXPECT_EQ(0, alive);
+}
+
+TEST(RunnableInlineStorage, BigTaskOnHeap)
+{
+	std::atomic<int> alive{0};
+	std::atomic<int> launches{0};
+	{
+		std::array<char, runnable_inline_size * 2> big_capture{};
+		auto runnable = Runnable::create(
+			[&, big_capture, counter = DestroyCounter{alive}]
+			{
+				launches += 1 + big_capture[0];
+			},
+			__FILE__,
+			__LINE__);
+		EXPECT_FALSE(runnable.is_inline());
+
+		Runnable moved{std::move(runnable)};
+		EXPECT_FALSE(moved.is_inline());
+		EXPECT_EQ(1, alive);
+		moved.run(std::atomic<bool>{true});
+		EXPECT_EQ(1, launches);
+	}
+	EXPECT_EQ(0, alive);
+}
+
+TEST(RunnableInlineStorage, NestedTaskIsInline)
+{
+	static_assert(std::is_nothrow_move_constructible_v<Runnable>);
+	static_assert(std::is_nothrow_move_assignable_v<Runnable>);
+	static_assert(std::is_nothrow_move_constructible_v<ReschedulableRunnable>);
+
+	std::atomic<int> launches{0};
+	auto nested = Runnable::create(
+		[&]
+		{
+			++launches;
+		},
+		__FILE__,
+		__LINE__);
+	auto runnable = BasicRunnable<sizeof(Runnable) * 2>::create(
+		[nested = std::move(nested)]() mutable
+		{
+			nested.run(std::atomic<bool>{true});
+		},
+		__FILE__,
+		__LINE__);
+	EXPECT_TRUE(runnable.is_inline());
+	runnable.run(std::atomic<bool>{true});
+	EXPECT_EQ(1, launches);
+}
+
+TEST(RunnableInlineStorage, ExecuteOnHighWay)
+{
+	const auto highway = hi::make_self_shared<HighWay>();
+	std::atomic<int> alive{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	highway->execute(
+		[&, counter = DestroyCounter{alive}]
+		{
+			promise.set_value(true);
+		});
+	EXPECT_TRUE(future.get());
+	highway->flush_tasks();
+	EXPECT_EQ(0, alive);
+
+	highway->destroy();
+}
+
 } // namespace
 } // namespace hi
@@ -0,0 +1,170 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+std::vector<Runnable> make_batch(std::vector<std::uint32_t> & launches, const std::uint32_t from, const std::uint32_t cnt)
+{
+	std::vector<Runnable> batch;
+	for (std::uint32_t i = from; i < from + cnt; ++i)
+	{
+		batch.emplace_back(Runnable::create(
+			[&launches, i]
+			{
+				launches.push_back(i);
+			},
+			__FILE__,
+			__LINE__));
+	}
+	return batch;
+}
+
+TEST(TestBatch, HighWayExecutesInOrder)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+
+	std::vector<std::uint32_t> launches;
+	highway->execute_batch(make_batch(launches, 0, 10));
+	highway->execute(
+		[&]
+		{
+			launches.push_back(10);
+		});
+	highway->execute_batch(make_batch(launches, 11, 10));
+	highway->flush_tasks();
+
+	ASSERT_EQ(21u, launches.size());
+	for (std::uint32_t i = 0; i < launches.size(); ++i)
+	{
+		EXPECT_EQ(i, launches[i]);
+	}
+
+	highway->destroy();
+}
+
+TEST(TestBatch, HighWayBatchBiggerThanCapacity)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+	highway->set_capacity(4);
+
+	std::vector<std::uint32_t> launches;
+	highway->execute_batch(make_batch(launches, 0, 100));
+	highway->flush_tasks();
+
+	ASSERT_EQ(100u, launches.size());
+	for (std::uint32_t i = 0; i < launches.size(); ++i)
+	{
+		EXPECT_EQ(i, launches[i]);
+	}
+
+	highway->destroy();
+}
+
+TEST(TestBatch, TryExecuteBatchAllOrNothing)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+	highway->set_capacity(5);
+
+	// occupy the highway so the holders stay in use
+	std::promise<void> release;
+	auto release_future = release.get_future().share();
+	highway->execute(
+		[release_future]
+		{
+			release_future.wait();
+		});
+
+	std::vector<std::uint32_t> launches;
+	auto batch = make_batch(launches, 0, 5);
+	EXPECT_FALSE(highway->try_execute_batch(std::move(batch)));
+	EXPECT_EQ(5u, batch.size());
+	batch.resize(4);
+	EXPECT_TRUE(highway->try_execute_batch(std::move(batch)));
+
+	release.set_value();
+	highway->flush_tasks();
+	ASSERT_EQ(4u, launches.size());
+	for (std::uint32_t i = 0; i < launches.size(); ++i)
+	{
+		EXPECT_EQ(i, launches[i]);
+	}
+
+	highway->destroy();
+}
+
+TEST(TestBatch, HighWayProxy)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+	auto proxy = make_proxy(highway);
+
+	std::vector<std::uint32_t> launches;
+	EXPECT_TRUE(proxy->execute_batch(make_batch(launches, 0, 8)));
+	EXPECT_TRUE(proxy->try_execute_batch(make_batch(launches, 8, 8)));
+	highway->flush_tasks();
+	EXPECT_EQ(16u, launches.size());
+
+	highway->destroy();
+	highway.reset();
+	EXPECT_FALSE(proxy->execute_batch(make_batch(launches, 0, 8)));
+}
+
+template <typename Executor>
+void check_all_executed(Executor & executor)
+{
+	const std::uint32_t batches_cnt{100};
+	const std::uint32_t batch_size{64};
+	std::atomic<std::uint32_t> executed{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	for (std::uint32_t b = 0; b < batches_cnt; ++b)
+	{
+		std::vector<Runnable> batch;
+		for (std::uint32_t i = 0; i < batch_size; ++i)
+		{
+			batch.emplace_back(Runnable::create(
+				[&]
+				{
+					if (++executed == batches_cnt * batch_size)
+					{
+						promise.set_value(true);
+					}
+				},
+				__FILE__,
+				__LINE__));
+		}
+		executor.execute_batch(std::move(batch));
+	}
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+	EXPECT_EQ(batches_cnt * batch_size, executed.load());
+}
+
+TEST(TestBatch, MultiThreadedTaskProcessingPlant)
+{
+	auto plant = hi::make_self_shared<MultiThreadedTaskProcessingPlant>(4u);
+	check_all_executed(*plant);
+	plant->destroy();
+}
+
+TEST(TestBatch, HighWaysManager)
+{
+	auto manager = hi::make_self_shared<HighWaysManager>(2u, 2u);
+	check_all_executed(*manager);
+}
+
+} // namespace hi
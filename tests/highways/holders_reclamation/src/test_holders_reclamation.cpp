@@ -0,0 +1,286 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+struct Message
+{
+	void clear()
+	{
+		id_ = 0;
+	}
+
+	std::uint32_t id_{0};
+};
+
+template <typename Condition>
+bool wait_for(Condition && condition, const std::chrono::milliseconds max_wait = 5000ms)
+{
+	const auto deadline = std::chrono::steady_clock::now() + max_wait;
+	while (!condition())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::sleep_for(5ms);
+	}
+	return true;
+}
+
+// Allocating the holders up to the capacity and returning them
+void burst(MailBox<Message> & mail_box, const std::uint32_t cnt)
+{
+	for (std::uint32_t i = 0; i < cnt; ++i)
+	{
+		EXPECT_TRUE(mail_box.send_may_fail(Message{i}));
+	}
+	std::uint32_t received{0};
+	while (auto holder = mail_box.pop_message_no_wait())
+	{
+		EXPECT_EQ(received, holder->t_.id_);
+		++received;
+		mail_box.free_holder(holder);
+	}
+	EXPECT_EQ(cnt, received);
+}
+
+} // namespace
+
+TEST(TestEpochReclamation, RetiredAreDeletedWhenNobodyIsPinned)
+{
+	EpochReclamation<Holder<Message>> epochs;
+	std::optional<EpochReclamation<Holder<Message>>::Guard> guard;
+	guard.emplace(&epochs);
+
+	auto first = new Holder<Message>{};
+	first->next_in_stack_ = new Holder<Message>{};
+	epochs.retire(first);
+	EXPECT_EQ(2u, epochs.retired_cnt());
+
+	// the pinned thread may still read the retired holders
+	for (int i = 0; i < 4; ++i)
+	{
+		epochs.reclaim();
+	}
+	EXPECT_EQ(2u, epochs.retired_cnt());
+
+	guard.reset();
+	for (int i = 0; i < 4; ++i)
+	{
+		epochs.reclaim();
+	}
+	EXPECT_EQ(0u, epochs.retired_cnt());
+}
+
+TEST(TestEpochReclamation, SynchronizeWaitsForPinnedThreads)
+{
+	EpochReclamation<Holder<Message>> epochs;
+	std::optional<EpochReclamation<Holder<Message>>::Guard> guard;
+	guard.emplace(&epochs);
+
+	std::atomic<bool> synchronized{false};
+	std::thread reclaimer{[&]
+						  {
+							  epochs.synchronize();
+							  synchronized = true;
+						  }};
+	std::this_thread::sleep_for(20ms);
+	EXPECT_FALSE(synchronized);
+
+	guard.reset();
+	reclaimer.join();
+	EXPECT_TRUE(synchronized);
+}
+
+TEST(TestHoldersReclamation, ShrinksToLowWatermarkAfterBurst)
+{
+	MailBox<Message> mail_box{1000u};
+	mail_box.set_holders_reclamation(HoldersReclamation{100u, 20ms});
+
+	burst(mail_box, 1000u);
+	EXPECT_EQ(1000u, mail_box.allocated_holders());
+	const auto burst_heap_usage = mail_box.heap_usage();
+	EXPECT_EQ(1000u * holder_footprint<Message>(false), burst_heap_usage);
+
+	EXPECT_TRUE(wait_for(
+		[&]
+		{
+			return mail_box.allocated_holders() == 100u && mail_box.heap_usage() == 100u * holder_footprint<Message>(false);
+		}));
+	EXPECT_LT(mail_box.heap_usage(), burst_heap_usage);
+
+	// the next burst allocates the holders again
+	burst(mail_box, 1000u);
+	EXPECT_EQ(1000u, mail_box.allocated_holders());
+	mail_box.destroy();
+}
+
+TEST(TestHoldersReclamation, ZeroCoolDownNeverFrees)
+{
+	MailBox<Message> mail_box{500u};
+	mail_box.set_holders_reclamation(HoldersReclamation{0u, 0ms});
+	burst(mail_box, 500u);
+	std::this_thread::sleep_for(50ms);
+	EXPECT_EQ(500u, mail_box.allocated_holders());
+	mail_box.destroy();
+}
+
+TEST(TestHoldersReclamation, TurnedOffAfterBurst)
+{
+	MailBox<Message> mail_box{1000u};
+	mail_box.set_holders_reclamation(HoldersReclamation{100u, 20ms});
+	burst(mail_box, 1000u);
+	EXPECT_TRUE(wait_for(
+		[&]
+		{
+			return mail_box.allocated_holders() == 100u && mail_box.heap_usage() == 100u * holder_footprint<Message>(false);
+		}));
+
+	// the retired holders are deleted right away, the next burst stays allocated
+	mail_box.set_holders_reclamation(HoldersReclamation{100u, 0ms});
+	EXPECT_EQ(100u * holder_footprint<Message>(false), mail_box.heap_usage());
+	burst(mail_box, 1000u);
+	std::this_thread::sleep_for(60ms);
+	EXPECT_EQ(1000u, mail_box.allocated_holders());
+	EXPECT_EQ(1000u * holder_footprint<Message>(false), mail_box.heap_usage());
+	mail_box.destroy();
+}
+
+TEST(TestHoldersReclamation, ConcurrentProducersAndConsumers)
+{
+	MailBox<Message> mail_box{256u};
+	mail_box.set_holders_reclamation(HoldersReclamation{0u, 1ms});
+
+	const std::uint32_t producers_cnt{3};
+	const std::uint32_t messages_per_producer{100000};
+	std::atomic<std::uint32_t> received{0};
+	std::atomic<bool> keep_execution{true};
+
+	std::vector<std::thread> consumers;
+	for (int i = 0; i < 2; ++i)
+	{
+		consumers.emplace_back(
+			[&]
+			{
+				while (keep_execution.load(std::memory_order_relaxed))
+				{
+					if (auto holder = mail_box.pop_message_no_wait())
+					{
+						mail_box.free_holder(holder);
+						received.fetch_add(1u, std::memory_order_relaxed);
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+	}
+
+	std::vector<std::thread> producers;
+	for (std::uint32_t i = 0; i < producers_cnt; ++i)
+	{
+		producers.emplace_back(
+			[&]
+			{
+				for (std::uint32_t id = 0; id < messages_per_producer; ++id)
+				{
+					mail_box.send_may_blocked(Message{id});
+					if (id % 10000 == 0)
+					{
+						// give the reclaimer a chance to find the idle holders
+						std::this_thread::sleep_for(2ms);
+					}
+				}
+			});
+	}
+	for (auto & it : producers)
+	{
+		it.join();
+	}
+
+	EXPECT_TRUE(wait_for(
+		[&]
+		{
+			return received.load() == producers_cnt * messages_per_producer;
+		}));
+	keep_execution = false;
+	for (auto & it : consumers)
+	{
+		it.join();
+	}
+
+	EXPECT_TRUE(wait_for(
+		[&]
+		{
+			return mail_box.allocated_holders() == 0u;
+		}));
+	mail_box.destroy();
+}
+
+TEST(TestHoldersReclamation, HighWayMetricsShowHeapUsage)
+{
+	RAIIdestroy highway{make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		1000u)};
+	highway.object_->set_holders_reclamation(HoldersReclamation{10u, 20ms});
+
+	std::promise<bool> release;
+	auto release_future = release.get_future().share();
+	highway.object_->execute(
+		[release_future]
+		{
+			release_future.wait();
+		});
+	for (std::uint32_t i = 0; i < 999; ++i)
+	{
+		highway.object_->execute([] {});
+	}
+	EXPECT_EQ(1000u, highway.object_->metrics().holders_allocated_);
+	const auto burst_heap_usage = highway.object_->metrics().heap_usage_;
+	EXPECT_GT(burst_heap_usage, 0u);
+
+	release.set_value(true);
+	highway.object_->flush_tasks();
+	EXPECT_TRUE(wait_for(
+		[&]
+		{
+			const auto metrics = highway.object_->metrics();
+			// the retired holders are deleted one check later
+			return metrics.holders_allocated_ == 10u && metrics.heap_usage_ == burst_heap_usage / 100u;
+		}));
+
+	std::promise<bool> executed;
+	highway.object_->execute(
+		[&]
+		{
+			executed.set_value(true);
+		});
+	EXPECT_EQ(std::future_status::ready, executed.get_future().wait_for(5s));
+}
+
+} // namespace hi
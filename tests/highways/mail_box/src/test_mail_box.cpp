@@ -0,0 +1,346 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/semaphore.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+// the slabs tests below use the mailboxes of strings
+template <>
+struct SlabHolders<std::string> : std::true_type
+{
+};
+
+using event_types = ::testing::Types<EventCount, Semaphore>;
+
+template <class T>
+struct TestMailBox : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(TestMailBox, event_types);
+
+TYPED_TEST(TestMailBox, MoveToTimeout)
+{
+	MailBox<std::string, TypeParam> mail_box;
+	SingleThreadStack<Holder<std::string>> work_queue;
+
+	const auto start = std::chrono::steady_clock::now();
+	mail_box.move_to(work_queue, 20ms);
+	EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+	EXPECT_TRUE(work_queue.empty());
+
+	mail_box.destroy();
+}
+
+TYPED_TEST(TestMailBox, ConsumerWakesUpOnMessage)
+{
+	MailBox<std::string, TypeParam> mail_box;
+
+	std::promise<std::string> promise;
+	auto future = promise.get_future();
+	std::thread consumer(
+		[&]
+		{
+			auto holder = mail_box.pop_message();
+			ASSERT_NE(nullptr, holder);
+			promise.set_value(holder->t_);
+			mail_box.free_holder(holder);
+		});
+
+	std::this_thread::sleep_for(10ms);
+	EXPECT_TRUE(mail_box.send_may_fail(std::string{"message"}));
+	ASSERT_EQ(std::future_status::ready, future.wait_for(1s));
+	EXPECT_EQ("message", future.get());
+
+	consumer.join();
+	mail_box.destroy();
+}
+
+TYPED_TEST(TestMailBox, DestroyWakesUpConsumer)
+{
+	MailBox<std::string, TypeParam> mail_box;
+
+	std::promise<Holder<std::string> *> promise;
+	auto future = promise.get_future();
+	std::thread consumer(
+		[&]
+		{
+			promise.set_value(mail_box.pop_message());
+		});
+
+	std::this_thread::sleep_for(10ms);
+	mail_box.destroy();
+	ASSERT_EQ(std::future_status::ready, future.wait_for(1s));
+	EXPECT_EQ(nullptr, future.get());
+
+	consumer.join();
+}
+
+TYPED_TEST(TestMailBox, BlockedSenderWakesUpOnFreeHolder)
+{
+	MailBox<std::string, TypeParam> mail_box;
+	mail_box.set_capacity(1);
+	EXPECT_TRUE(mail_box.send_may_fail(std::string{"first"}));
+	EXPECT_FALSE(mail_box.send_may_fail(std::string{"second"}));
+
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	std::thread sender(
+		[&]
+		{
+			mail_box.send_may_blocked(std::string{"second"});
+			promise.set_value(true);
+		});
+
+	EXPECT_EQ(std::future_status::timeout, future.wait_for(10ms));
+	auto holder = mail_box.pop_message();
+	ASSERT_NE(nullptr, holder);
+	EXPECT_EQ("first", holder->t_);
+	mail_box.free_holder(holder);
+	ASSERT_EQ(std::future_status::ready, future.wait_for(1s));
+
+	holder = mail_box.pop_message();
+	ASSERT_NE(nullptr, holder);
+	EXPECT_EQ("second", holder->t_);
+	mail_box.free_holder(holder);
+
+	sender.join();
+	mail_box.destroy();
+}
+
+TYPED_TEST(TestMailBox, ProducersAndConsumers)
+{
+	MailBox<std::string, TypeParam> mail_box;
+	mail_box.set_capacity(8);
+
+	const std::uint32_t producers_cnt{4};
+	const std::uint32_t consumers_cnt{4};
+	const std::uint32_t messages_cnt{10000};
+	std::atomic<std::uint32_t> received{0};
+
+	std::vector<std::thread> threads;
+	for (std::uint32_t i = 0; i < consumers_cnt; ++i)
+	{
+		threads.emplace_back(
+			[&]
+			{
+				while (auto holder = mail_box.pop_message())
+				{
+					mail_box.free_holder(holder);
+					++received;
+				}
+			});
+	}
+	for (std::uint32_t i = 0; i < producers_cnt; ++i)
+	{
+		threads.emplace_back(
+			[&]
+			{
+				for (std::uint32_t msg = 0; msg < messages_cnt; ++msg)
+				{
+					mail_box.send_may_blocked(std::to_string(msg));
+				}
+			});
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+	while (received.load() < producers_cnt * messages_cnt && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(producers_cnt * messages_cnt, received.load());
+
+	mail_box.destroy();
+	for (auto && it : threads)
+	{
+		it.join();
+	}
+}
+
+TYPED_TEST(TestMailBox, AbaSafeBlockedSenderWakesUp)
+{
+	MailBoxAbaSafe<std::uint32_t, TypeParam> mail_box{4};
+
+	const std::uint32_t messages_cnt{1000};
+	std::uint32_t received{0};
+	std::thread consumer(
+		[&]
+		{
+			while (received < messages_cnt)
+			{
+				if (auto holder = mail_box.pop_message())
+				{
+					++received;
+					mail_box.free_work_queue_holder(*holder);
+				}
+			}
+		});
+
+	for (std::uint32_t msg = 0; msg < messages_cnt; ++msg)
+	{
+		mail_box.send_may_blocked(std::uint32_t{msg});
+	}
+
+	consumer.join();
+	EXPECT_EQ(messages_cnt, received);
+	mail_box.destroy();
+}
+
+TEST(TestMailBoxSlabs, PrefaultAllocatesWholeCapacity)
+{
+	MailBox<std::string> mail_box{100u, HoldersAllocation{16u, false, true}};
+	EXPECT_EQ(100u, mail_box.allocated_holders());
+	// 6 slabs of 16 holders and the last one is cut by the capacity
+	EXPECT_EQ(
+		6u * (64u + 16u * holder_footprint<std::string>(true)) + 64u + 4u * holder_footprint<std::string>(true),
+		mail_box.heap_usage());
+
+	for (std::uint32_t msg = 0; msg < 100u; ++msg)
+	{
+		EXPECT_TRUE(mail_box.send_may_fail(std::to_string(msg)));
+	}
+	EXPECT_FALSE(mail_box.send_may_fail("no holders"));
+	EXPECT_EQ(100u, mail_box.allocated_holders());
+
+	std::uint32_t received{0};
+	while (auto holder = mail_box.pop_message_no_wait())
+	{
+		// every holder starts a cache line
+		EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(holder) % 64u);
+		EXPECT_EQ(std::to_string(received), holder->t_);
+		++received;
+		mail_box.free_holder(holder);
+	}
+	EXPECT_EQ(100u, received);
+	mail_box.destroy();
+}
+
+TEST(TestMailBoxSlabs, OnlySlabHoldersArePrefixed)
+{
+	static_assert(Holder<Runnable>::prefix_size() > 0u);
+	static_assert(Holder<ReschedulableRunnable>::prefix_size() == 0u);
+	static_assert(Holder<std::uint32_t>::prefix_size() == 0u);
+
+	// not SlabHolders: allocated one by one whatever is asked
+	MailBox<std::uint32_t> mail_box{100u, HoldersAllocation{16u, false, true}};
+	EXPECT_EQ(100u, mail_box.allocated_holders());
+	EXPECT_EQ(100u * holder_footprint<std::uint32_t>(false), mail_box.heap_usage());
+	EXPECT_EQ(sizeof(Holder<std::uint32_t>), holder_footprint<std::uint32_t>(false));
+	mail_box.destroy();
+}
+
+TEST(TestMailBoxSlabs, HugePagesRoundedInHeapUsage)
+{
+	MailBox<std::string> mail_box{100u, HoldersAllocation{16u, true, true}};
+	EXPECT_EQ(100u, mail_box.allocated_holders());
+	// 7 slabs, each one is rounded up to the huge page (where they are supported)
+	EXPECT_EQ(7u * slab_memory_size(64u + 16u * holder_footprint<std::string>(true), true), mail_box.heap_usage());
+	mail_box.destroy();
+}
+
+TEST(TestMailBoxSlabs, SlabsAllocatedOnDemand)
+{
+	MailBox<std::string> mail_box{40u, HoldersAllocation{16u, true, false}};
+	EXPECT_EQ(0u, mail_box.allocated_holders());
+
+	// new holders are preferred until the capacity is reached (see aba_safe_get_free_holder): slab by slab
+	EXPECT_TRUE(mail_box.send_may_fail("0"));
+	EXPECT_EQ(16u, mail_box.allocated_holders());
+	EXPECT_TRUE(mail_box.send_may_fail("1"));
+	EXPECT_EQ(32u, mail_box.allocated_holders());
+	EXPECT_TRUE(mail_box.send_may_fail("2"));
+	// the last slab is cut by the capacity
+	EXPECT_EQ(40u, mail_box.allocated_holders());
+	for (std::uint32_t msg = 3; msg < 40u; ++msg)
+	{
+		EXPECT_TRUE(mail_box.send_may_fail(std::to_string(msg)));
+	}
+	EXPECT_EQ(40u, mail_box.allocated_holders());
+	EXPECT_FALSE(mail_box.send_may_fail("no holders"));
+	mail_box.destroy();
+}
+
+TEST(TestMailBoxSlabs, SlabHoldersReclaimedOneByOne)
+{
+	MailBox<std::string> mail_box{256u, HoldersAllocation{32u, false, true}};
+	mail_box.set_holders_reclamation(HoldersReclamation{0u, 1ms});
+
+	std::atomic<std::uint32_t> received{0};
+	std::thread consumer(
+		[&]
+		{
+			while (auto holder = mail_box.pop_message())
+			{
+				mail_box.free_holder(holder);
+				++received;
+			}
+		});
+	const std::uint32_t messages_cnt{20000};
+	for (std::uint32_t msg = 0; msg < messages_cnt; ++msg)
+	{
+		mail_box.send_may_blocked(std::to_string(msg));
+		if (msg % 2000 == 0)
+		{
+			std::this_thread::sleep_for(3ms);
+		}
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+	while ((received.load() < messages_cnt || mail_box.heap_usage()) && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(messages_cnt, received.load());
+	EXPECT_EQ(0u, mail_box.heap_usage());
+
+	mail_box.destroy();
+	consumer.join();
+}
+
+TEST(TestMailBoxSlabs, HighWayWithSlabs)
+{
+	RAIIdestroy highway{make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		1000u,
+		nullptr,
+		PriorityLanes{},
+		ThreadPlacement{},
+		nullptr,
+		HoldersAllocation{64u, true, true})};
+	EXPECT_EQ(1000u, highway.object_->metrics().holders_allocated_);
+
+	std::uint32_t executed{0};
+	for (std::uint32_t i = 0; i < 10000; ++i)
+	{
+		highway.object_->execute(
+			[&]
+			{
+				++executed;
+			});
+	}
+	highway.object_->flush_tasks();
+	EXPECT_EQ(10000u, executed);
+	EXPECT_EQ(1000u, highway.object_->metrics().holders_allocated_);
+}
+
+} // namespace hi
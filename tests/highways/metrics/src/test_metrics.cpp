@@ -0,0 +1,298 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+static_assert(THREAD_HIGHWAYS_METRICS, "the test is built with metrics");
+
+namespace
+{
+
+// Keeps the highway busy until released
+struct Blocker
+{
+	template <typename Executor>
+	explicit Blocker(Executor & executor)
+	{
+		auto future = release_.get_future().share();
+		std::promise<bool> started;
+		auto started_future = started.get_future();
+		executor.execute(
+			[future, &started]
+			{
+				started.set_value(true);
+				future.wait();
+			});
+		started_future.wait();
+	}
+
+	~Blocker()
+	{
+		release();
+	}
+
+	void release()
+	{
+		if (!released_)
+		{
+			released_ = true;
+			release_.set_value(true);
+		}
+	}
+
+	std::promise<bool> release_;
+	bool released_{false};
+};
+
+} // namespace
+
+TEST(TestMetrics, LogHistogramBuckets)
+{
+	EXPECT_EQ(0u, LogHistogram::bucket(0u));
+	EXPECT_EQ(1u, LogHistogram::bucket(1u));
+	EXPECT_EQ(2u, LogHistogram::bucket(2u));
+	EXPECT_EQ(2u, LogHistogram::bucket(3u));
+	EXPECT_EQ(11u, LogHistogram::bucket(1024u));
+	EXPECT_EQ(LogHistogram::buckets_cnt - 1u, LogHistogram::bucket(~std::uint64_t{0}));
+
+	LogHistogram histogram;
+	histogram.buckets_[LogHistogram::bucket(100u)] = 99u;
+	histogram.buckets_[LogHistogram::bucket(1000000u)] = 1u;
+	EXPECT_EQ(100u, histogram.count());
+	EXPECT_EQ(128ns, histogram.percentile(0.5));
+	EXPECT_EQ(128ns, histogram.percentile(0.98));
+	EXPECT_EQ(1048576ns, histogram.percentile(1.0));
+	EXPECT_EQ(0ns, LogHistogram{}.percentile(0.5));
+}
+
+TEST(TestMetrics, HighWayCounters)
+{
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		1000u);
+
+	const std::uint64_t tasks_cnt{100};
+	for (std::uint64_t i = 0; i < tasks_cnt; ++i)
+	{
+		highway->execute(
+			[]
+			{
+			});
+	}
+	std::vector<Runnable> batch;
+	for (std::uint64_t i = 0; i < tasks_cnt; ++i)
+	{
+		batch.emplace_back(Runnable::create(
+			[]
+			{
+			},
+			__FILE__,
+			__LINE__));
+	}
+	highway->execute_batch(std::move(batch));
+	highway->flush_tasks();
+
+	const auto metrics = highway->metrics();
+	// + flush task
+	EXPECT_EQ(2u * tasks_cnt + 1u, metrics.submitted_);
+	// the flush task may still be finishing
+	EXPECT_GE(metrics.executed_, 2u * tasks_cnt);
+	EXPECT_LE(metrics.queue_depth_, 1u);
+	EXPECT_EQ(0u, metrics.dropped_);
+	EXPECT_EQ(metrics.executed_, metrics.execution_time_.count());
+	EXPECT_EQ(metrics.executed_, metrics.queueing_delay_.count());
+	EXPECT_EQ(1000u, metrics.holders_capacity_);
+	EXPECT_GT(metrics.holders_allocated_, 0u);
+	EXPECT_LE(metrics.holders_allocated_, metrics.holders_capacity_);
+
+	highway->destroy();
+}
+
+TEST(TestMetrics, HighWayDroppedAndQueueDepth)
+{
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		10u);
+
+	Blocker blocker{*highway};
+	std::uint64_t sent{0};
+	std::uint64_t dropped{0};
+	for (std::uint32_t i = 0; i < 20; ++i)
+	{
+		if (highway->try_execute(
+				[]
+				{
+				}))
+		{
+			++sent;
+		}
+		else
+		{
+			++dropped;
+		}
+	}
+	EXPECT_GT(dropped, 0u);
+
+	auto metrics = highway->metrics();
+	EXPECT_EQ(dropped, metrics.dropped_);
+	// the blocker is being executed
+	EXPECT_EQ(sent + 1u, metrics.queue_depth_);
+	EXPECT_EQ(10u, metrics.holders_allocated_);
+
+	blocker.release();
+	highway->flush_tasks();
+	metrics = highway->metrics();
+	EXPECT_LE(metrics.queue_depth_, 1u);
+
+	highway->destroy();
+}
+
+TEST(TestMetrics, QueueingDelayAndExecutionTime)
+{
+	auto highway = make_self_shared<HighWay>();
+	{
+		Blocker blocker{*highway};
+		highway->execute(
+			[]
+			{
+				std::this_thread::sleep_for(5ms);
+			});
+		std::this_thread::sleep_for(20ms);
+	}
+	highway->flush_tasks();
+
+	const auto metrics = highway->metrics();
+	// the blocker waited for 20ms, the task waited for it
+	EXPECT_GE(metrics.execution_time_.percentile(1.0), 20ms);
+	EXPECT_GE(metrics.queueing_delay_.percentile(1.0), 20ms);
+	EXPECT_GE(metrics.execution_time_.percentile(0.5), 5ms);
+
+	highway->destroy();
+}
+
+TEST(TestMetrics, PriorityLanesCounted)
+{
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		1000u,
+		nullptr,
+		PriorityLanes{PriorityLanes::Order::Strict, 1u, {{100u, 1u}}});
+
+	for (std::uint32_t i = 0; i < 10; ++i)
+	{
+		highway->execute(
+			Priority{1},
+			[]
+			{
+			});
+	}
+	highway->flush_tasks();
+
+	const auto metrics = highway->metrics();
+	EXPECT_EQ(11u, metrics.submitted_);
+	EXPECT_EQ(1100u, metrics.holders_capacity_);
+
+	highway->destroy();
+}
+
+TEST(TestMetrics, PlantCounters)
+{
+	auto plant = make_self_shared<MultiThreadedTaskProcessingPlant>(2u);
+
+	const std::uint32_t tasks_cnt{100};
+	std::atomic<std::uint32_t> executed{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		plant->execute(
+			[&]
+			{
+				if (++executed == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+	}
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+
+	const auto metrics = plant->metrics();
+	EXPECT_EQ(tasks_cnt, metrics.submitted_);
+	// the last task may still be finishing
+	EXPECT_GE(metrics.executed_ + 2u, tasks_cnt);
+	EXPECT_EQ(65000u, metrics.holders_capacity_);
+
+	plant->destroy();
+}
+
+TEST(TestMetrics, ManagerCounters)
+{
+	auto manager = make_self_shared<HighWaysManager>(1u, 2u, false);
+
+	const std::uint32_t tasks_cnt{100};
+	std::atomic<std::uint32_t> executed{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		manager->execute(
+			[&]
+			{
+				if (++executed == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+	}
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+
+	const auto metrics = manager->metrics();
+	EXPECT_EQ(tasks_cnt, metrics.submitted_);
+	EXPECT_GE(metrics.executed_ + 3u, tasks_cnt);
+
+	auto highway = manager->get_highway(50u);
+	std::promise<bool> highway_promise;
+	auto highway_future = highway_promise.get_future();
+	highway->execute(
+		[&]
+		{
+			highway_promise.set_value(true);
+		});
+	ASSERT_EQ(std::future_status::ready, highway_future.wait_for(5s));
+
+	const auto highways_metrics = manager->highways_metrics();
+	ASSERT_EQ(2u, highways_metrics.size());
+	EXPECT_EQ(1u, highways_metrics[0].submitted_ + highways_metrics[1].submitted_);
+}
+
+} // namespace hi
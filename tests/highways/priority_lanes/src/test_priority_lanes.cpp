@@ -0,0 +1,232 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+std::shared_ptr<HighWay> make_highway(PriorityLanes priority_lanes)
+{
+	return hi::make_self_shared<HighWay>(
+		[](const hi::Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		65000u,
+		nullptr,
+		std::move(priority_lanes));
+}
+
+// Holds the highway thread until release
+struct Blocker
+{
+	Blocker(HighWay & highway)
+	{
+		highway.execute(
+			[future = promise_.get_future().share(), &started = started_]
+			{
+				started.set_value();
+				future.wait();
+			});
+		started_.get_future().wait();
+	}
+
+	void release()
+	{
+		promise_.set_value();
+	}
+
+	std::promise<void> promise_;
+	std::promise<void> started_;
+};
+
+TEST(TestPriorityLanes, StrictUrgentFirst)
+{
+	auto highway = make_highway(PriorityLanes{PriorityLanes::Order::Strict, 1u, {{}, {}}});
+
+	std::vector<std::uint32_t> launches;
+	Blocker blocker{*highway};
+	for (std::uint32_t i = 0; i < 5; ++i)
+	{
+		highway->execute(
+			[&]
+			{
+				launches.push_back(0);
+			});
+		highway->execute(
+			Priority{1},
+			[&]
+			{
+				launches.push_back(1);
+			});
+		highway->execute(
+			Priority{2},
+			[&]
+			{
+				launches.push_back(2);
+			});
+	}
+	blocker.release();
+	highway->flush_tasks();
+
+	const std::vector<std::uint32_t> expected{2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+	EXPECT_EQ(expected, launches);
+
+	highway->destroy();
+}
+
+TEST(TestPriorityLanes, WeightedRoundRobin)
+{
+	auto highway = make_highway(PriorityLanes{PriorityLanes::Order::WeightedRoundRobin, 1u, {{65000u, 2u}}});
+
+	std::vector<std::uint32_t> launches;
+	Blocker blocker{*highway};
+	for (std::uint32_t i = 0; i < 6; ++i)
+	{
+		highway->execute(
+			[&]
+			{
+				launches.push_back(0);
+			});
+		highway->execute(
+			Priority{1},
+			[&]
+			{
+				launches.push_back(1);
+			});
+	}
+	blocker.release();
+	highway->flush_tasks();
+
+	ASSERT_EQ(12u, launches.size());
+	// the default lane is not starved: it is served between the rounds of the priority lane
+	const auto first_default = std::find(launches.begin(), launches.end(), 0u);
+	const auto last_urgent = std::find(launches.rbegin(), launches.rend(), 1u).base();
+	EXPECT_LT(first_default, last_urgent);
+	// and the priority lane gets twice as much
+	EXPECT_EQ(1u, launches[0]);
+	EXPECT_EQ(1u, launches[1]);
+
+	highway->destroy();
+}
+
+TEST(TestPriorityLanes, IdleHighWayWakesUp)
+{
+	auto highway = make_highway(PriorityLanes{PriorityLanes::Order::Strict, 1u, {{}}});
+	// let the highway fall asleep on the main mailbox
+	highway->flush_tasks();
+	std::this_thread::sleep_for(10ms);
+
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	highway->execute(
+		Priority{1},
+		[&]
+		{
+			promise.set_value(true);
+		});
+	EXPECT_EQ(std::future_status::ready, future.wait_for(1s));
+
+	highway->destroy();
+}
+
+TEST(TestPriorityLanes, LaneCapacity)
+{
+	auto highway = make_highway(PriorityLanes{PriorityLanes::Order::Strict, 1u, {{2u, 1u}}});
+
+	std::uint32_t executed{0};
+	Blocker blocker{*highway};
+	EXPECT_TRUE(highway->try_execute(
+		Priority{1},
+		[&]
+		{
+			++executed;
+		}));
+	EXPECT_TRUE(highway->try_execute(
+		Priority{1},
+		[&]
+		{
+			++executed;
+		}));
+	EXPECT_FALSE(highway->try_execute(
+		Priority{1},
+		[&]
+		{
+			++executed;
+		}));
+	// the main mailbox has its own capacity
+	EXPECT_TRUE(highway->try_execute(
+		[&]
+		{
+			++executed;
+		}));
+	blocker.release();
+	highway->flush_tasks();
+	EXPECT_EQ(3u, executed);
+
+	highway->destroy();
+}
+
+TEST(TestPriorityLanes, ProxyAndPriorityOutOfRange)
+{
+	auto highway = make_highway(PriorityLanes{PriorityLanes::Order::Strict, 1u, {{}}});
+	auto proxy = make_proxy(highway);
+
+	std::vector<std::uint32_t> launches;
+	Blocker blocker{*highway};
+	EXPECT_TRUE(proxy->execute(
+		[&]
+		{
+			launches.push_back(0);
+		}));
+	// greater than the number of lanes - the most urgent lane
+	EXPECT_TRUE(proxy->execute(
+		Priority{100},
+		[&]
+		{
+			launches.push_back(1);
+		}));
+	blocker.release();
+	highway->flush_tasks();
+	EXPECT_EQ((std::vector<std::uint32_t>{1, 0}), launches);
+
+	highway->destroy();
+	highway.reset();
+	EXPECT_FALSE(proxy->execute(
+		Priority{1},
+		[]
+		{
+		}));
+}
+
+TEST(TestPriorityLanes, NoLanesMeansDefault)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	highway->execute(
+		Priority{1},
+		[&]
+		{
+			promise.set_value(true);
+		});
+	EXPECT_EQ(std::future_status::ready, future.wait_for(1s));
+	highway->destroy();
+}
+
+} // namespace hi
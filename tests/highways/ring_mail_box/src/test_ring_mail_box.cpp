@@ -0,0 +1,347 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+Runnable make_runnable(std::vector<std::uint32_t> & launches, const std::uint32_t id)
+{
+	return Runnable::create(
+		[&launches, id]
+		{
+			launches.push_back(id);
+		},
+		__FILE__,
+		__LINE__);
+}
+
+// Extracting and executing everything that is in the ring now
+std::uint32_t execute_all(RingMailBox<Runnable> & mail_box)
+{
+	std::atomic<bool> keep_execution{true};
+	std::uint32_t re{0};
+	while (auto slot = mail_box.pop_message_no_wait())
+	{
+		slot->t_.run(keep_execution);
+		mail_box.free_holder(slot);
+		++re;
+	}
+	return re;
+}
+
+struct Message
+{
+	void clear()
+	{
+		id_ = 0u;
+	}
+
+	std::uint32_t id_{0u};
+};
+
+template <typename T, typename = void>
+struct Resizable : std::false_type
+{
+};
+
+template <typename T>
+struct Resizable<T, std::void_t<decltype(std::declval<T &>().set_capacity(1u))>> : std::true_type
+{
+};
+
+} // namespace
+
+TEST(TestRingMailBox, CapacityIsPowerOfTwo)
+{
+	EXPECT_EQ(2u, RingMailBox<Runnable>{0u}.capacity());
+	EXPECT_EQ(8u, RingMailBox<Runnable>{5u}.capacity());
+	EXPECT_EQ(1024u, RingMailBox<Runnable>{}.capacity());
+	static_assert(alignof(RingMailBox<Runnable>::Slot) >= 64u, "slots are cache-line-aligned");
+	// the ring is sized by the constructor only: no set_capacity() that silently does nothing
+	static_assert(!Resizable<RingMailBox<Runnable>>::value);
+	static_assert(Resizable<MailBox<Runnable>>::value);
+}
+
+TEST(TestRingMailBox, SendMayFailWhenFull)
+{
+	RingMailBox<Runnable> mail_box{4u};
+	std::vector<std::uint32_t> launches;
+	for (std::uint32_t i = 0; i < 4; ++i)
+	{
+		EXPECT_TRUE(mail_box.send_may_fail(make_runnable(launches, i)));
+	}
+	EXPECT_FALSE(mail_box.send_may_fail(make_runnable(launches, 4)));
+
+	// one slot is returned => one more message
+	auto slot = mail_box.pop_message_no_wait();
+	ASSERT_NE(nullptr, slot);
+	std::atomic<bool> keep_execution{true};
+	slot->t_.run(keep_execution);
+	EXPECT_FALSE(mail_box.send_may_fail(make_runnable(launches, 4)));
+	mail_box.free_holder(slot);
+	EXPECT_TRUE(mail_box.send_may_fail(make_runnable(launches, 4)));
+
+	EXPECT_EQ(4u, execute_all(mail_box));
+	EXPECT_FALSE(mail_box.has_messages());
+	EXPECT_EQ((std::vector<std::uint32_t>{0, 1, 2, 3, 4}), launches);
+}
+
+TEST(TestRingMailBox, BatchAllOrNothing)
+{
+	RingMailBox<Runnable> mail_box{8u};
+	std::vector<std::uint32_t> launches;
+	EXPECT_TRUE(mail_box.send_may_fail(make_runnable(launches, 0)));
+	EXPECT_TRUE(mail_box.send_may_fail(make_runnable(launches, 1)));
+
+	std::vector<Runnable> batch;
+	for (std::uint32_t i = 2; i < 9; ++i)
+	{
+		batch.emplace_back(make_runnable(launches, i));
+	}
+	// 7 messages, 6 free slots
+	EXPECT_FALSE(mail_box.send_batch_may_fail(std::move(batch)));
+	ASSERT_EQ(7u, batch.size());
+
+	batch.pop_back();
+	EXPECT_TRUE(mail_box.send_batch_may_fail(std::move(batch)));
+	EXPECT_FALSE(mail_box.send_may_fail(make_runnable(launches, 8)));
+
+	EXPECT_EQ(8u, execute_all(mail_box));
+	EXPECT_EQ((std::vector<std::uint32_t>{0, 1, 2, 3, 4, 5, 6, 7}), launches);
+}
+
+TEST(TestRingMailBox, SendMayBlockedWaitsForFreeSlot)
+{
+	RingMailBox<Runnable> mail_box{2u};
+	std::vector<std::uint32_t> launches;
+	mail_box.send_may_blocked(make_runnable(launches, 0));
+	mail_box.send_may_blocked(make_runnable(launches, 1));
+
+	auto sent = std::async(
+		std::launch::async,
+		[&]
+		{
+			mail_box.send_may_blocked(make_runnable(launches, 2));
+		});
+	EXPECT_EQ(std::future_status::timeout, sent.wait_for(50ms));
+
+	auto slot = mail_box.pop_message_no_wait();
+	ASSERT_NE(nullptr, slot);
+	std::atomic<bool> keep_execution{true};
+	slot->t_.run(keep_execution);
+	mail_box.free_holder(slot);
+	EXPECT_EQ(std::future_status::ready, sent.wait_for(5s));
+
+	EXPECT_EQ(2u, execute_all(mail_box));
+	EXPECT_EQ((std::vector<std::uint32_t>{0, 1, 2}), launches);
+}
+
+TEST(TestRingMailBox, DestroyReleasesBlockedSender)
+{
+	RingMailBox<Runnable> mail_box{2u};
+	std::vector<std::uint32_t> launches;
+	mail_box.send_may_blocked(make_runnable(launches, 0));
+	mail_box.send_may_blocked(make_runnable(launches, 1));
+
+	auto sent = std::async(
+		std::launch::async,
+		[&]
+		{
+			mail_box.send_may_blocked(make_runnable(launches, 2));
+		});
+	EXPECT_EQ(std::future_status::timeout, sent.wait_for(50ms));
+	mail_box.destroy();
+	EXPECT_EQ(std::future_status::ready, sent.wait_for(5s));
+}
+
+TEST(TestRingMailBox, ManyProducersKeepTheirOrder)
+{
+	RingMailBox<Message> mail_box{64u};
+	const std::uint32_t producers_cnt{4};
+	const std::uint32_t messages_cnt{10000};
+
+	std::vector<std::thread> producers;
+	for (std::uint32_t producer = 0; producer < producers_cnt; ++producer)
+	{
+		producers.emplace_back(
+			[&, producer]
+			{
+				for (std::uint32_t i = 0; i < messages_cnt; ++i)
+				{
+					mail_box.send_may_blocked(Message{producer * messages_cnt + i});
+				}
+			});
+	}
+
+	std::vector<std::uint32_t> next(producers_cnt, 0u);
+	RingMailBox<Message>::WorkQueue work_queue;
+	for (std::uint32_t received = 0; received < producers_cnt * messages_cnt;)
+	{
+		mail_box.move_to(work_queue, 10ms);
+		while (auto slot = work_queue.pop())
+		{
+			const auto producer = slot->t_.id_ / messages_cnt;
+			EXPECT_EQ(next[producer], slot->t_.id_ % messages_cnt);
+			next[producer] = slot->t_.id_ % messages_cnt + 1u;
+			mail_box.free_holder(slot);
+			++received;
+		}
+	}
+	for (auto & producer : producers)
+	{
+		producer.join();
+	}
+	EXPECT_TRUE(work_queue.empty());
+}
+
+TEST(TestRingMailBox, RingHighWayExecutes)
+{
+	auto highway = make_self_shared<RingHighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"RingHighWay",
+		std::chrono::milliseconds{},
+		64u);
+
+	const std::uint32_t producers_cnt{3};
+	const std::uint32_t tasks_cnt{1000};
+	std::atomic<std::uint32_t> executed{0};
+	std::vector<std::thread> producers;
+	for (std::uint32_t producer = 0; producer < producers_cnt; ++producer)
+	{
+		producers.emplace_back(
+			[&]
+			{
+				for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+				{
+					highway->execute(
+						[&]
+						{
+							++executed;
+						});
+				}
+			});
+	}
+	for (auto & producer : producers)
+	{
+		producer.join();
+	}
+	highway->flush_tasks();
+	EXPECT_EQ(producers_cnt * tasks_cnt, executed.load());
+
+	std::vector<std::uint32_t> launches;
+	std::vector<Runnable> batch;
+	for (std::uint32_t i = 0; i < 100; ++i)
+	{
+		batch.emplace_back(make_runnable(launches, i));
+	}
+	// bigger than the ring: sent by parts
+	highway->execute_batch(std::move(batch));
+	highway->flush_tasks();
+	ASSERT_EQ(100u, launches.size());
+	for (std::uint32_t i = 0; i < launches.size(); ++i)
+	{
+		EXPECT_EQ(i, launches[i]);
+	}
+
+	highway->destroy();
+}
+
+TEST(TestRingMailBox, RingHighWayTryExecuteFailsWhenFull)
+{
+	auto highway = make_self_shared<RingHighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"RingHighWay",
+		std::chrono::milliseconds{100},
+		8u);
+
+	std::promise<bool> release;
+	auto release_future = release.get_future().share();
+	std::promise<bool> started;
+	highway->execute(
+		[&, release_future]
+		{
+			started.set_value(true);
+			release_future.wait();
+		});
+	started.get_future().wait();
+
+	// the blocker occupies its slot while being executed
+	std::uint32_t sent{0};
+	while (highway->try_execute(
+		[]
+		{
+		}))
+	{
+		++sent;
+	}
+	EXPECT_EQ(7u, sent);
+
+	release.set_value(true);
+	highway->flush_tasks();
+	EXPECT_TRUE(highway->try_execute(
+		[]
+		{
+		}));
+
+	highway->destroy();
+}
+
+TEST(TestRingMailBox, RingHighWaySchedulesAndPriorityLanes)
+{
+	auto highway = make_self_shared<RingHighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"RingHighWay",
+		std::chrono::milliseconds{},
+		16u,
+		nullptr,
+		PriorityLanes{PriorityLanes::Order::Strict, 1u, {{16u, 1u}}});
+
+	std::promise<bool> scheduled;
+	highway->schedule(
+		[&](Schedule &)
+		{
+			scheduled.set_value(true);
+		},
+		std::chrono::steady_clock::now() + 10ms);
+	EXPECT_EQ(std::future_status::ready, scheduled.get_future().wait_for(5s));
+
+	std::promise<bool> urgent;
+	highway->execute(
+		Priority{1},
+		[&]
+		{
+			urgent.set_value(true);
+		});
+	EXPECT_EQ(std::future_status::ready, urgent.get_future().wait_for(5s));
+
+	highway->destroy();
+}
+
+} // namespace hi
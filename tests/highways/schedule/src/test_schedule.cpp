@@ -0,0 +1,134 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+using highway_types = ::testing::Types<HighWay, HighWayAbaSafe>;
+
+template <class T>
+struct TestSchedule : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(TestSchedule, highway_types);
+
+TYPED_TEST(TestSchedule, LaunchInTimeOrder)
+{
+	auto highway = hi::make_self_shared<TypeParam>();
+
+	const std::uint32_t tasks_cnt{20};
+	std::vector<std::uint32_t> launches;
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	// scheduled in reverse order: the later task is scheduled earlier
+	const auto start = std::chrono::steady_clock::now() + 50ms;
+	for (std::uint32_t i = tasks_cnt; i > 0; --i)
+	{
+		highway->schedule(
+			[&, i](Schedule &)
+			{
+				launches.push_back(i);
+				if (launches.size() == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			},
+			start + i * 5ms,
+			__FILE__,
+			__LINE__);
+	}
+
+	EXPECT_EQ(std::future_status::ready, future.wait_for(5s));
+	ASSERT_EQ(tasks_cnt, launches.size());
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		EXPECT_EQ(i + 1, launches[i]);
+	}
+
+	highway->destroy();
+}
+
+TYPED_TEST(TestSchedule, NotLaunchedBeforeTime)
+{
+	auto highway = hi::make_self_shared<TypeParam>();
+
+	std::promise<std::chrono::steady_clock::time_point> promise;
+	auto future = promise.get_future();
+
+	const auto planned_time = std::chrono::steady_clock::now() + 100ms;
+	highway->schedule(
+		[&](Schedule &)
+		{
+			promise.set_value(std::chrono::steady_clock::now());
+		},
+		planned_time,
+		__FILE__,
+		__LINE__);
+
+	// the highway keeps executing other tasks while waiting for the scheduled one
+	for (std::uint32_t i = 0; i < 100; ++i)
+	{
+		highway->execute(
+			[]
+			{
+			});
+	}
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+	EXPECT_GE(future.get(), planned_time);
+
+	highway->destroy();
+}
+
+TYPED_TEST(TestSchedule, Reschedule)
+{
+	auto highway = hi::make_self_shared<TypeParam>();
+
+	const std::uint32_t tasks_cnt{100};
+	const std::uint32_t launches_cnt{5};
+	std::uint32_t total_launches{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		highway->schedule(
+			[&, launches = 0u](Schedule & schedule) mutable
+			{
+				++total_launches;
+				if (++launches < launches_cnt)
+				{
+					schedule.schedule_launch_in(1ms);
+				}
+				else if (total_launches == tasks_cnt * launches_cnt)
+				{
+					promise.set_value(true);
+				}
+			},
+			{},
+			__FILE__,
+			__LINE__);
+	}
+
+	EXPECT_EQ(std::future_status::ready, future.wait_for(5s));
+	highway->flush_tasks();
+	EXPECT_EQ(tasks_cnt * launches_cnt, total_launches);
+
+	highway->destroy();
+}
+
+} // namespace hi
@@ -0,0 +1,347 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/thread_placement.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+#if __linux__ && !__ANDROID__
+#	include <pthread.h>
+#	include <sched.h>
+#	include <sys/resource.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+#if __linux__ && !__ANDROID__
+
+namespace
+{
+
+std::vector<std::uint32_t> this_thread_cores()
+{
+	std::vector<std::uint32_t> re;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+	for (std::uint32_t core = 0; core < CPU_SETSIZE; ++core)
+	{
+		if (CPU_ISSET(core, &set))
+		{
+			re.push_back(core);
+		}
+	}
+	return re;
+}
+
+template <typename Fun>
+auto on_highway(const std::shared_ptr<HighWay> & highway, Fun && fun)
+{
+	std::promise<decltype(fun())> promise;
+	auto future = promise.get_future();
+	highway->execute(
+		[&]
+		{
+			promise.set_value(fun());
+		});
+	EXPECT_EQ(std::future_status::ready, future.wait_for(5s));
+	return future.get();
+}
+
+} // namespace
+
+TEST(TestThreadPlacement, NumaNodeCoresParsed)
+{
+	// node0 exists on any Linux with sysfs
+	const auto cores = numa_node_cores(0);
+	if (cores.empty())
+	{
+		GTEST_SKIP() << "no /sys/devices/system/node";
+	}
+	EXPECT_TRUE(std::is_sorted(cores.begin(), cores.end()));
+	EXPECT_TRUE(numa_node_cores(100000).empty());
+}
+
+TEST(TestThreadPlacement, HighWayPinnedToCore)
+{
+	const auto allowed = allowed_cores();
+	ASSERT_FALSE(allowed.empty());
+	const auto core = allowed.back();
+
+	ThreadPlacement placement;
+	placement.cores_ = {core};
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		65000u,
+		nullptr,
+		PriorityLanes{},
+		placement);
+
+	const auto cores = on_highway(
+		highway,
+		[]
+		{
+			return this_thread_cores();
+		});
+	EXPECT_EQ(std::vector<std::uint32_t>{core}, cores);
+	const auto cpu = on_highway(
+		highway,
+		[]
+		{
+			return sched_getcpu();
+		});
+	EXPECT_EQ(static_cast<int>(core), cpu);
+
+	highway->destroy();
+}
+
+TEST(TestThreadPlacement, HighWayOnNumaNode)
+{
+	if (numa_node_cores(0).empty())
+	{
+		GTEST_SKIP() << "no /sys/devices/system/node";
+	}
+
+	ThreadPlacement placement;
+	placement.numa_node_ = 0;
+	placement.numa_local_holders_ = true;
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		1000u,
+		nullptr,
+		PriorityLanes{},
+		placement);
+
+	const auto cores = on_highway(
+		highway,
+		[]
+		{
+			return this_thread_cores();
+		});
+	const auto node_cores = numa_node_cores(0);
+	for (auto core : cores)
+	{
+		EXPECT_NE(node_cores.end(), std::find(node_cores.begin(), node_cores.end(), core));
+	}
+
+	// all the holders are already allocated by the highway thread
+	std::atomic<std::uint32_t> executed{0};
+	for (std::uint32_t i = 0; i < 10000; ++i)
+	{
+		highway->execute(
+			[&]
+			{
+				++executed;
+			});
+	}
+	highway->flush_tasks();
+	EXPECT_EQ(10000u, executed.load());
+
+	highway->destroy();
+}
+
+TEST(TestThreadPlacement, HighWayStackSizeAndNice)
+{
+	const std::size_t stack_size{16u * 1024u * 1024u};
+	ThreadPlacement placement;
+	placement.stack_size_ = stack_size;
+	placement.nice_ = 5;
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		65000u,
+		nullptr,
+		PriorityLanes{},
+		placement);
+
+	const auto real_stack_size = on_highway(
+		highway,
+		[]
+		{
+			pthread_attr_t attr;
+			std::size_t re{0};
+			if (pthread_getattr_np(pthread_self(), &attr) == 0)
+			{
+				pthread_attr_getstacksize(&attr, &re);
+				pthread_attr_destroy(&attr);
+			}
+			return re;
+		});
+	EXPECT_GE(real_stack_size, stack_size);
+
+	const auto nice = on_highway(
+		highway,
+		[]
+		{
+			return getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+		});
+	EXPECT_EQ(5, nice);
+
+	highway->destroy();
+}
+
+TEST(TestThreadPlacement, HighWayWorksWithoutRightsForFifo)
+{
+	ThreadPlacement placement;
+	placement.fifo_priority_ = 10;
+	auto highway = make_self_shared<HighWay>(
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWay",
+		std::chrono::milliseconds{},
+		65000u,
+		nullptr,
+		PriorityLanes{},
+		placement);
+
+	// SCHED_FIFO is applied if allowed, otherwise the highway works as usual
+	const auto policy = on_highway(
+		highway,
+		[]
+		{
+			return sched_getscheduler(0);
+		});
+	EXPECT_TRUE(policy == SCHED_FIFO || policy == SCHED_OTHER);
+
+	highway->destroy();
+}
+
+TEST(TestThreadPlacement, PlantWorkersSpreadAcrossCores)
+{
+	const auto allowed = allowed_cores();
+	const std::uint32_t workers_cnt{4};
+
+	ThreadPlacement placement;
+	placement.spread_across_cores_ = true;
+	auto plant = make_self_shared<MultiThreadedTaskProcessingPlant>(
+		workers_cnt,
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"MultiThreadedTaskProcessingPlant",
+		std::chrono::milliseconds{},
+		65000u,
+		placement);
+
+	const std::uint32_t tasks_cnt{100};
+	std::mutex mutex;
+	std::vector<std::vector<std::uint32_t>> workers_cores;
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		plant->execute(
+			[&]
+			{
+				auto cores = this_thread_cores();
+				std::lock_guard lg{mutex};
+				workers_cores.emplace_back(std::move(cores));
+				if (workers_cores.size() == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+	}
+	EXPECT_EQ(std::future_status::ready, future.wait_for(5s));
+	plant->destroy();
+
+	ASSERT_FALSE(workers_cores.empty());
+	for (const auto & cores : workers_cores)
+	{
+		ASSERT_EQ(1u, cores.size());
+		EXPECT_NE(allowed.end(), std::find(allowed.begin(), allowed.end(), cores[0]));
+	}
+}
+
+TEST(TestThreadPlacement, ManagerSpreadsThreadsAcrossCores)
+{
+	const auto allowed = allowed_cores();
+
+	ThreadPlacement placement;
+	placement.spread_across_cores_ = true;
+	auto manager = make_self_shared<HighWaysManager>(
+		2u,
+		2u,
+		false,
+		[](const Exception & ex)
+		{
+			throw ex;
+		},
+		"HighWaysManager",
+		65000u,
+		HighWaysManager::HighWaySettings{},
+		placement);
+
+	std::vector<std::uint32_t> highways_cores;
+	for (std::uint32_t i = 0; i < 2; ++i)
+	{
+		auto highway = manager->get_highway(50u);
+		std::promise<std::vector<std::uint32_t>> promise;
+		auto future = promise.get_future();
+		highway->execute(
+			[&]
+			{
+				promise.set_value(this_thread_cores());
+			});
+		ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+		const auto cores = future.get();
+		ASSERT_EQ(1u, cores.size());
+		highways_cores.push_back(cores[0]);
+	}
+
+	// 2 local workers + 2 highways are placed one by one over the allowed cores
+	if (allowed.size() >= 4u)
+	{
+		EXPECT_NE(highways_cores[0], highways_cores[1]);
+	}
+}
+
+#endif // __linux__ && !__ANDROID__
+
+TEST(TestThreadPlacement, DefaultPlacementChangesNothing)
+{
+	auto highway = make_self_shared<HighWay>();
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	highway->execute(
+		[&]
+		{
+			promise.set_value(apply_this_thread_placement(ThreadPlacement{}));
+		});
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+	EXPECT_TRUE(future.get());
+	highway->destroy();
+}
+
+} // namespace hi
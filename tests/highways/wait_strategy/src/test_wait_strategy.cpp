@@ -0,0 +1,213 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+struct TestWaitStrategy : public ::testing::TestWithParam<WaitStrategy>
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(
+	TestWaitStrategyInstance,
+	TestWaitStrategy,
+	::testing::Values(WaitStrategy::Block, WaitStrategy::SpinThenPark, WaitStrategy::BusyPoll),
+	[](const ::testing::TestParamInfo<WaitStrategy> & test_info)
+	{
+		switch (test_info.param)
+		{
+		case WaitStrategy::Block:
+			return std::string{"Block"};
+		case WaitStrategy::SpinThenPark:
+			return std::string{"SpinThenPark"};
+		case WaitStrategy::BusyPoll:
+			return std::string{"BusyPoll"};
+		}
+		return std::string{};
+	});
+
+TEST_P(TestWaitStrategy, HighWayPingPong)
+{
+	auto ping = hi::make_self_shared<HighWay>();
+	auto pong = hi::make_self_shared<HighWay>();
+	ping->set_wait_strategy(GetParam());
+	pong->set_wait_strategy(GetParam());
+
+	const std::uint32_t round_trips{1000};
+	std::uint32_t done{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	std::function<void()> send_ping = [&]
+	{
+		pong->execute(
+			[&]
+			{
+				ping->execute(
+					[&]
+					{
+						if (++done == round_trips)
+						{
+							promise.set_value(true);
+							return;
+						}
+						send_ping();
+					});
+			});
+	};
+	send_ping();
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+	EXPECT_EQ(round_trips, done);
+
+	ping->destroy();
+	pong->destroy();
+}
+
+TEST_P(TestWaitStrategy, HighWayScheduleInTime)
+{
+	auto highway = hi::make_self_shared<HighWay>();
+	highway->set_wait_strategy(GetParam());
+
+	std::promise<std::chrono::steady_clock::time_point> promise;
+	auto future = promise.get_future();
+	const auto planned_time = std::chrono::steady_clock::now() + 20ms;
+	highway->schedule(
+		[&](Schedule &)
+		{
+			promise.set_value(std::chrono::steady_clock::now());
+		},
+		planned_time,
+		__FILE__,
+		__LINE__);
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+	EXPECT_GE(future.get(), planned_time);
+
+	highway->destroy();
+}
+
+TEST_P(TestWaitStrategy, MultiThreadedTaskProcessingPlant)
+{
+	auto plant = hi::make_self_shared<MultiThreadedTaskProcessingPlant>(2u);
+	plant->set_wait_strategy(GetParam());
+
+	const std::uint32_t tasks_cnt{1000};
+	std::atomic<std::uint32_t> done{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		plant->execute(
+			[&]
+			{
+				if (++done == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+		if (i % 100 == 0)
+		{
+			// let the workers fall idle
+			std::this_thread::sleep_for(1ms);
+		}
+	}
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+	plant->destroy();
+}
+
+TEST_P(TestWaitStrategy, HighWaysManager)
+{
+	auto manager = hi::make_self_shared<HighWaysManager>(1u, 2u);
+	manager->set_wait_strategy(GetParam());
+
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	std::this_thread::sleep_for(5ms);
+	manager->execute(
+		[&]
+		{
+			promise.set_value(true);
+		});
+	ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+}
+
+TEST(TestIdleWaiter, AdaptiveSpinLimit)
+{
+	if (std::thread::hardware_concurrency() < 2u)
+	{
+		GTEST_SKIP() << "SpinThenPark does not spin on a single core";
+	}
+	const std::atomic<WaitStrategy> strategy{WaitStrategy::SpinThenPark};
+	IdleWaiter idle_waiter{strategy};
+	const auto initial = idle_waiter.spin_limit();
+
+	// spinning never helps => the spin becomes shorter
+	for (std::uint32_t i = 0; i < 10; ++i)
+	{
+		EXPECT_FALSE(idle_waiter.spin(
+			[]
+			{
+				return false;
+			},
+			std::chrono::steady_clock::time_point::max()));
+	}
+	const auto after_misses = idle_waiter.spin_limit();
+	EXPECT_LT(after_misses, initial);
+
+	// spinning helps => the spin becomes longer
+	for (std::uint32_t i = 0; i < 10; ++i)
+	{
+		EXPECT_TRUE(idle_waiter.spin(
+			[]
+			{
+				return true;
+			},
+			std::chrono::steady_clock::time_point::max()));
+	}
+	EXPECT_GT(idle_waiter.spin_limit(), after_misses);
+}
+
+TEST(TestIdleWaiter, BlockDoesNotSpin)
+{
+	const std::atomic<WaitStrategy> strategy{WaitStrategy::Block};
+	IdleWaiter idle_waiter{strategy};
+	std::uint32_t checks{0};
+	EXPECT_FALSE(idle_waiter.spin(
+		[&]
+		{
+			++checks;
+			return true;
+		},
+		std::chrono::steady_clock::time_point::max()));
+	EXPECT_EQ(0u, checks);
+}
+
+TEST(TestIdleWaiter, BusyPollUntilDeadline)
+{
+	const std::atomic<WaitStrategy> strategy{WaitStrategy::BusyPoll};
+	IdleWaiter idle_waiter{strategy};
+	const auto start = std::chrono::steady_clock::now();
+	EXPECT_FALSE(idle_waiter.spin(
+		[]
+		{
+			return false;
+		},
+		start + 5ms));
+	EXPECT_GE(std::chrono::steady_clock::now() - start, 5ms);
+}
+
+} // namespace hi
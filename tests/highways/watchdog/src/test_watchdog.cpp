@@ -0,0 +1,244 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+struct Reports
+{
+	ExceptionHandler handler()
+	{
+		return [this](const Exception & ex)
+		{
+			std::lock_guard lg{mutex_};
+			reports_.emplace_back(ex.file_name() ? ex.file_name() : "", ex.file_line());
+			cv_.notify_all();
+		};
+	}
+
+	bool wait(const std::size_t cnt, const std::chrono::milliseconds timeout)
+	{
+		std::unique_lock lk{mutex_};
+		return cv_.wait_for(
+			lk,
+			timeout,
+			[&]
+			{
+				return reports_.size() >= cnt;
+			});
+	}
+
+	std::size_t size()
+	{
+		std::lock_guard lg{mutex_};
+		return reports_.size();
+	}
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::pair<std::string, unsigned int>> reports_;
+};
+
+} // namespace
+
+TEST(TestWatchdog, StuckTaskReportedWhileRunning)
+{
+	Reports reports;
+	auto highway = make_self_shared<HighWay>(reports.handler(), "HighWay", 20ms);
+
+	std::promise<bool> release;
+	auto released = release.get_future().share();
+	const unsigned int line = __LINE__ + 1;
+	highway->execute(
+		[released]
+		{
+			released.wait();
+		},
+		__FILE__,
+		line);
+
+	// the task is still running
+	ASSERT_TRUE(reports.wait(1u, 5s));
+	EXPECT_EQ(std::string{__FILE__}, reports.reports_[0].first);
+	EXPECT_EQ(line, reports.reports_[0].second);
+
+	// reported only once per task
+	std::this_thread::sleep_for(100ms);
+	EXPECT_EQ(1u, reports.size());
+
+	release.set_value(true);
+	highway->flush_tasks();
+	highway->destroy();
+}
+
+TEST(TestWatchdog, FastTasksNotReported)
+{
+	Reports reports;
+	auto highway = make_self_shared<HighWay>(reports.handler(), "HighWay", 50ms);
+
+	for (std::uint32_t i = 0; i < 100; ++i)
+	{
+		highway->execute(
+			[]
+			{
+				std::this_thread::sleep_for(1ms);
+			});
+	}
+	highway->flush_tasks();
+	std::this_thread::sleep_for(100ms);
+	EXPECT_EQ(0u, reports.size());
+
+	highway->destroy();
+}
+
+TEST(TestWatchdog, StuckScheduledTaskReported)
+{
+	Reports reports;
+	auto highway = make_self_shared<HighWay>(reports.handler(), "HighWay", 20ms);
+
+	std::promise<bool> release;
+	auto released = release.get_future().share();
+	highway->schedule(
+		[released](Schedule &)
+		{
+			released.wait();
+		},
+		{},
+		__FILE__,
+		__LINE__);
+
+	EXPECT_TRUE(reports.wait(1u, 5s));
+	release.set_value(true);
+	highway->destroy();
+}
+
+TEST(TestWatchdog, PlantStuckWorkerReported)
+{
+	Reports reports;
+	auto plant = make_self_shared<MultiThreadedTaskProcessingPlant>(2u, reports.handler(), "Plant", 20ms);
+
+	std::promise<bool> release;
+	auto released = release.get_future().share();
+	for (std::uint32_t i = 0; i < 2; ++i)
+	{
+		plant->execute(
+			[released]
+			{
+				released.wait();
+			});
+	}
+
+	// each stuck worker is reported
+	EXPECT_TRUE(reports.wait(2u, 5s));
+	release.set_value(true);
+	plant->destroy();
+}
+
+TEST(TestWatchdog, ManagerStuckWorkerReported)
+{
+	Reports reports;
+	auto manager = make_self_shared<HighWaysManager>(
+		1u,
+		1u,
+		false,
+		reports.handler(),
+		"HighWaysManager",
+		65000u,
+		HighWaysManager::HighWaySettings{20ms, 65000u});
+
+	std::promise<bool> release;
+	auto released = release.get_future().share();
+	manager->execute(
+		[released]
+		{
+			released.wait();
+		});
+
+	EXPECT_TRUE(reports.wait(1u, 5s));
+	release.set_value(true);
+}
+
+TEST(TestWatchdog, StuckTimeMeasuredFromTaskStart)
+{
+	Watchdog watchdog;
+	std::promise<std::pair<std::string, std::chrono::steady_clock::time_point>> report;
+	const auto watched = watchdog.watch(
+		"Watched",
+		200ms,
+		[&](const Exception & ex)
+		{
+			report.set_value({ex.what(), std::chrono::steady_clock::now()});
+		});
+
+	const auto started = std::chrono::steady_clock::now();
+	watched->task_started(__FILE__, __LINE__);
+	const auto [what, reported] = report.get_future().get();
+	watched->task_finished();
+
+	// not the time since the watchdog noticed the task (up to a check period later);
+	// 10ms: the precision of the coarse clock
+	const auto stuck_ms = std::stoll(what.substr(what.rfind('=') + 1));
+	const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(reported - started).count();
+	EXPECT_GE(elapsed_ms, 200 - 10);
+	EXPECT_GE(stuck_ms, 200);
+	EXPECT_GE(stuck_ms + 10, elapsed_ms);
+}
+
+TEST(TestWatchdog, ThrowingHandlerRethrownOnWatchedThread)
+{
+	Watchdog watchdog;
+	std::promise<void> reported;
+	const auto watched = watchdog.watch(
+		"Watched",
+		20ms,
+		[&](const Exception & ex)
+		{
+			reported.set_value();
+			throw ex;
+		});
+
+	watched->task_started(__FILE__, __LINE__);
+	reported.get_future().wait();
+	// the report is not lost: thrown when the stuck task finishes, as the handler was called by this thread
+	for (std::uint32_t i = 0; i < 100u; ++i)
+	{
+		try
+		{
+			watched->task_finished();
+		}
+		catch (const Exception & ex)
+		{
+			EXPECT_NE(nullptr, std::strstr(ex.what(), "stuck for ms"));
+			// only once
+			watched->task_started(__FILE__, __LINE__);
+			EXPECT_NO_THROW(watched->task_finished());
+			return;
+		}
+		// the handler is still returning
+		watched->task_started(__FILE__, __LINE__);
+		std::this_thread::sleep_for(1ms);
+	}
+	FAIL() << "the report of the throwing handler is lost";
+}
+
+} // namespace hi
@@ -0,0 +1,207 @@
+/*
+ * This is the source code of thread_highways library
+ *
+ * Copyright (c) Dmitriy Bondarenko
+ * feel free to contact me: bondarenkoda@gmail.com
+ */
+
+#include <thread_highways/include_all.h>
+#include <thread_highways/tools/work_stealing_deque.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace hi
+{
+
+using namespace std::chrono_literals;
+
+TEST(TestWorkStealingDeque, OwnerLifoThiefFifo)
+{
+	std::vector<int> items{0, 1, 2, 3, 4};
+	WorkStealingDeque<int> deque{2};
+	EXPECT_TRUE(deque.empty());
+	for (auto & it : items)
+	{
+		deque.push(&it);
+	}
+	EXPECT_EQ(5, deque.size());
+	EXPECT_EQ(&items[4], deque.pop());
+	EXPECT_EQ(&items[0], deque.steal());
+	EXPECT_EQ(&items[3], deque.pop());
+	EXPECT_EQ(&items[1], deque.steal());
+	EXPECT_EQ(&items[2], deque.pop());
+	EXPECT_EQ(nullptr, deque.pop());
+	EXPECT_EQ(nullptr, deque.steal());
+	EXPECT_TRUE(deque.empty());
+}
+
+TEST(TestWorkStealingDeque, EachItemTakenOnce)
+{
+	const std::uint32_t items_cnt{200000};
+	const std::uint32_t thieves_cnt{3};
+	std::vector<std::atomic<std::uint32_t>> taken(items_cnt);
+	std::vector<std::uint32_t> items(items_cnt);
+	for (std::uint32_t i = 0; i < items_cnt; ++i)
+	{
+		items[i] = i;
+	}
+
+	WorkStealingDeque<std::uint32_t> deque{16};
+	std::atomic<bool> owner_finished{false};
+	std::vector<std::thread> thieves;
+	for (std::uint32_t i = 0; i < thieves_cnt; ++i)
+	{
+		thieves.emplace_back(
+			[&]
+			{
+				while (!owner_finished.load() || !deque.empty())
+				{
+					if (auto item = deque.steal())
+					{
+						++taken[*item];
+					}
+				}
+			});
+	}
+
+	for (std::uint32_t i = 0; i < items_cnt; ++i)
+	{
+		deque.push(&items[i]);
+		// the owner takes a part of the items itself
+		if (i % 3 == 0)
+		{
+			if (auto item = deque.pop())
+			{
+				++taken[*item];
+			}
+		}
+	}
+	while (auto item = deque.pop())
+	{
+		++taken[*item];
+	}
+	owner_finished = true;
+	for (auto & it : thieves)
+	{
+		it.join();
+	}
+
+	for (std::uint32_t i = 0; i < items_cnt; ++i)
+	{
+		ASSERT_EQ(1u, taken[i].load()) << "item " << i;
+	}
+}
+
+TEST(TestWorkStealing, TasksSpawnedByWorkersExecuted)
+{
+	auto manager = make_self_shared<HighWaysManager>(2u, 2u, false);
+
+	// binary tree of tasks: each task spawns two children from the worker thread
+	const std::uint32_t depth{12};
+	const std::uint32_t tasks_cnt{(1u << (depth + 1u)) - 1u};
+	std::atomic<std::uint32_t> executed{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	std::function<void(std::uint32_t)> spawn = [&](std::uint32_t level)
+	{
+		manager->execute(
+			[&, level]
+			{
+				if (level < depth)
+				{
+					spawn(level + 1u);
+					spawn(level + 1u);
+				}
+				if (++executed == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+	};
+	spawn(0u);
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+	EXPECT_EQ(tasks_cnt, executed.load());
+}
+
+TEST(TestWorkStealing, LocalTasksStolenByIdleWorkers)
+{
+	auto manager = make_self_shared<HighWaysManager>(3u, 1u, false);
+
+	const std::uint32_t tasks_cnt{30};
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	std::atomic<std::uint32_t> executed{0};
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+
+	// all the tasks are sent to the deque of one worker
+	manager->execute(
+		[&]
+		{
+			for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+			{
+				manager->execute(
+					[&]
+					{
+						{
+							std::lock_guard lg{mutex};
+							threads.insert(std::this_thread::get_id());
+						}
+						std::this_thread::sleep_for(2ms);
+						if (++executed == tasks_cnt)
+						{
+							promise.set_value(true);
+						}
+					});
+			}
+		});
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+	std::lock_guard lg{mutex};
+	EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(TestWorkStealing, HighWayKeepsOrderOfOwnTasks)
+{
+	auto manager = make_self_shared<HighWaysManager>(1u, 2u, false);
+	auto highway = manager->get_highway(50u);
+
+	const std::uint32_t tasks_cnt{1000};
+	std::vector<std::uint32_t> launches;
+	std::promise<bool> promise;
+	auto future = promise.get_future();
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		highway->execute(
+			[&, i]
+			{
+				launches.push_back(i);
+				// multi-threaded work from the highway goes to its deque
+				manager->execute(
+					[]
+					{
+						std::this_thread::yield();
+					});
+				if (launches.size() == tasks_cnt)
+				{
+					promise.set_value(true);
+				}
+			});
+	}
+
+	ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+	for (std::uint32_t i = 0; i < tasks_cnt; ++i)
+	{
+		ASSERT_EQ(i, launches[i]);
+	}
+}
+
+} // namespace hi